@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CameraPath.h"
+#include "GLCounters.h"
+#include "GPUTimers.h"
+
+#define BENCHMARK_DEFAULT_SEED 1337
+#define BENCHMARK_DEFAULT_STEP (1.0f / 60.0f)
+#define BENCHMARK_WARMUP_FRAMES 30
+#define BENCHMARK_ORBIT_RADIUS 150.0f
+#define BENCHMARK_ORBIT_HEIGHT 60.0f
+#define BENCHMARK_CULL_ZONE "LightCulling"   // GPU zone of the cluster light culling
+#define BENCHMARK_UPLOAD_ZONE "LightUpload"  // CPU zone of the light frustum culling and upload
+
+class Camera;
+
+// Replays a camera path with a fixed timestep, one path step per frame
+// whatever the frame took, and records the cost of every frame. The first
+// BENCHMARK_WARMUP_FRAMES frames hold the first pose and are not recorded.
+// GPU times come GPU_TIMER_LATENCY frames late, so the run goes on a few
+// frames after the path ends to collect them. The JSON report goes to
+// GetUserDataPath()/benchmarks unless an output file is given.
+//
+// With light counts the path is replayed once per count, each pass with its
+// own warmup, and the report summarizes every pass on its own.
+class Benchmark
+{
+public:
+    Benchmark(CameraPath path, const std::string& source, float step, uint64_t seed, const std::vector<int>& lightCounts = {});
+    ~Benchmark() = default;
+
+    Benchmark(const Benchmark&) = delete;
+    Benchmark& operator=(const Benchmark&) = delete;
+
+    // Start of a frame, after Window::NewFrame. Closes the previous frame with
+    // its wall time and GL counters, then moves the camera to the next pose.
+    // Returns false once every frame is recorded.
+    bool BeginFrame(Camera& camera, std::chrono::nanoseconds lastFrameTime, const GLFrameCounters& lastCounters);
+    // CPU time of the frame being recorded, from BeginFrame to before the swap
+    void SetCPUTime(std::chrono::nanoseconds time);
+
+    bool IsDone() const { return this->done; }
+    uint32_t GetFrameCount() const { return this->frameCount; }
+    // Stress lights the current pass runs with, 0 without light counts
+    int GetLightCount() const { return this->passes[this->pass].lights; }
+
+    // Returns the written file or "" on failure
+    std::string WriteReport(const std::string& output) const;
+
+private:
+    struct FrameSample
+    {
+        std::chrono::nanoseconds frameTime{0};
+        std::chrono::nanoseconds cpuTime{0};
+        std::chrono::nanoseconds gpuTime{0};
+        std::chrono::nanoseconds cullTime{0};       // GPU
+        std::chrono::nanoseconds lightUploadTime{0}; // CPU
+        bool gpuValid = false;
+        uint32_t drawCalls = 0;
+        uint32_t drawCommands = 0;
+        uint64_t triangles = 0;
+        uint64_t uploadBytes = 0;
+        uint32_t stateBinds = 0;
+    };
+
+    struct Pass
+    {
+        int lights = 0;
+        uint64_t gpuFrameBase = 0; // GPUTimers frame of its first recorded frame
+        size_t firstSample = 0;
+        bool started = false;
+    };
+
+    void CollectGPUTimes();
+    FrameSample* GetSample(uint32_t frame);
+
+    CameraPath path;
+    std::string source;
+    float step;
+    uint64_t seed;
+    uint32_t frameCount;
+
+    std::vector<FrameSample> samples;
+    std::vector<Pass> passes;
+    size_t pass = 0;
+    uint32_t frame = 0;   // Frames of the pass started, warmup included
+    uint32_t drainFrames = 0;
+    bool recording = false;
+    bool done = false;
+};
\ No newline at end of file
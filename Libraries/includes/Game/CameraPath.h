@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#define CAMERA_PATH_RECORD_INTERVAL 0.25f
+#define CAMERA_PATH_ORBIT_DURATION 30.0f
+#define CAMERA_PATH_ORBIT_KEYFRAMES 120
+
+struct CameraKeyframe
+{
+    float time; // Seconds from the start of the path
+    glm::vec3 position;
+    glm::vec3 orientation;
+};
+
+// Camera keyframes, sampled with linear interpolation. The text format is
+// one "time px py pz ox oy oz" keyframe per line, '#' starts a comment.
+class CameraPath
+{
+public:
+    CameraPath() = default;
+    ~CameraPath() = default;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    // Circle over the terrain looking at its center, the default benchmark path
+    static CameraPath Orbit(float radius, float height, float duration = CAMERA_PATH_ORBIT_DURATION);
+
+    // Keyframes must come in time order
+    void AddKeyframe(float time, glm::vec3 position, glm::vec3 orientation);
+    void Sample(float time, glm::vec3& position, glm::vec3& orientation) const;
+
+    float GetDuration() const { return this->keyframes.empty() ? 0.0f : this->keyframes.back().time; }
+    bool IsEmpty() const { return this->keyframes.empty(); }
+    void Clear() { this->keyframes.clear(); }
+
+private:
+    std::vector<CameraKeyframe> keyframes;
+};
\ No newline at end of file
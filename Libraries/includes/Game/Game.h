@@ -3,8 +3,14 @@
 #include <memory>
 
 #include "World.h"
+#include "GameOptions.h"
 #include "Camera.h"
 #include "Window.h"
+#include "GLState.h"
+#include "GLCounters.h"
+#include "AllocationTracker.h"
+#include "Benchmark.h"
+#include "CameraPath.h"
 // #include "UIManager.h"
 #include "UI/TextRenderer.h"
 #include "InputManager.h"
@@ -17,11 +23,14 @@ public:
     Game();
     ~Game();
 
-    void init();
+    void init(const GameOptions& options = GameOptions());
     void stop();
 
     void run();
 
+    // EXIT_FAILURE when a benchmark could not run or a budget was exceeded
+    int GetExitCode() const;
+
 private:
     void processInput();
     void update();
@@ -33,4 +42,9 @@ private:
     Camera camera;
     std::unique_ptr<World> world = nullptr;
     std::unique_ptr<UI::TextRenderer> textRenderer;
+    GameOptions options;
+    std::unique_ptr<Benchmark> benchmark;
+    bool benchmarkFailed = false;
+    CameraPath recordedPath;
+    float recordTime = 0.0f;
 };
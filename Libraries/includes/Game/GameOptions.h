@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "HitchDetector.h"
+#include "Logger.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define LIGHT_STRESS_MAX 4096
+#define TRACE_FRAMES_MAX 100000
+#define ALLOC_REPORT_FRAMES_MAX 100000
+
+// Command line of the game, see ParseGameOptions for the flags
+struct GameOptions
+{
+    std::vector<int> lightStress; // Point lights spawned over the terrain, a benchmark runs its path once per count, empty = none
+    int traceFrames = 0; // Frames captured into a trace from the start, 0 = none
+    float hitchThreshold = HITCH_DEFAULT_THRESHOLD; // Times the median frame time, 0 = off
+    bool pipelineStats = false; // GL_ARB_pipeline_statistics_query counters in the overlay
+    int allocReportFrames = 0; // Steady state frames covered by the allocation report, 0 = none
+    int64_t allocBudget = -1; // Allocations allowed in a steady state frame, the game exits after the report, < 0 = none
+    int64_t seed = -1; // Terrain seed, < 0 = random (BENCHMARK_DEFAULT_SEED in a benchmark)
+    std::string benchmarkPath; // Camera path file or "orbit", empty = interactive
+    std::string benchmarkOutput; // Report file, empty = under the user data path
+    float benchmarkStep = BENCHMARK_DEFAULT_STEP; // Seconds of path per frame
+    std::string recordPath; // Camera path written on exit, empty = none
+    bool asyncLog = true; // Log calls only queue the message, a writer thread prints it
+    LogOverflowPolicy logOverflow = LOG_OVERFLOW_BLOCK;
+};
+
+// Returns false on an invalid command line, after logging why
+bool ParseGameOptions(int argc, char** argv, GameOptions& options);
\ No newline at end of file
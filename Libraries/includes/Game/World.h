@@ -8,6 +8,8 @@
 
 #include "TerrainGenerator.h"
 #include "Light.h"
+#include "RenderQueue.h"
+#include "ClusteredLighting.h"
 
 
 
@@ -19,13 +21,26 @@ public:
     ~World();
 
     void Init();
+    // Before Init, the terrain noise is seeded from the clock otherwise
+    void SetTerrainSeed(uint64_t seed) { this->terrain.SetNoiseSeed(seed); }
+    // Benchmark scene: count point lights scattered over the terrain, same seed every run.
+    // Replaces the lights of the previous call, 0 removes them
+    void SetStressLights(int count);
+    int GetStressLights() const { return this->stressLights; }
     void Destroy();
 
     void Update();
 
     void Render(Camera& camera);
 
+    const RenderQueueStats& GetRenderStats() const { return this->renderQueue.GetStats(); }
+    size_t GetLightCount() const { return this->lightManager.GetLightCount(); }
+    size_t GetVisibleLightCount() const { return this->lightManager.GetVisibleLightCount(); }
+
 private:
     TerrainGenerator terrain;
     LightManager lightManager;
+    RenderQueue renderQueue;
+    ClusteredLighting clusteredLighting;
+    int stressLights = 0; // Added last, after the scene lights
 };
\ No newline at end of file
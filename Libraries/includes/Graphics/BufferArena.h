@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#define BUFFER_ARENA_INVALID_OFFSET SIZE_MAX
+
+struct BufferRange
+{
+    size_t offset = BUFFER_ARENA_INVALID_OFFSET;
+    size_t size = 0;
+
+    bool IsValid() const { return this->offset != BUFFER_ARENA_INVALID_OFFSET; }
+};
+
+// Sub-allocator: many small arrays share one GL buffer instead of each owning
+// its own. Ranges come first-fit from a sorted free list, freed neighbours are
+// merged, and the buffer grows geometrically (GPU copy) when nothing fits.
+// Offsets are multiples of the alignment, which does not need to be a power of
+// two: a vertex stride keeps every range on a whole vertex.
+class BufferArena
+{
+public:
+    BufferArena() = default;
+    ~BufferArena();
+
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+    bool Initialize(size_t capacity, size_t alignment = 16, GLenum usage = GL_DYNAMIC_DRAW);
+    void Destroy();
+
+    // The buffer name changes when it grows, compare GetID to know when to relink
+    bool Allocate(size_t size, BufferRange& range);
+    void Free(BufferRange& range);
+    void Upload(const BufferRange& range, const void* data, size_t size, size_t offset = 0) const;
+    void Reserve(size_t newCapacity);
+
+    GLuint GetID() const { return this->ID; }
+    size_t GetCapacity() const { return this->capacity; }
+    size_t GetUsed() const { return this->used; }
+
+private:
+    GLuint ID = 0;
+    GLenum usage = GL_DYNAMIC_DRAW;
+    size_t alignment = 16;
+    size_t capacity = 0;
+    size_t end = 0;  // First byte never allocated
+    size_t used = 0;
+    std::vector<BufferRange> freeRanges; // Sorted by offset
+};
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #include "Shader.h"
 #include "UBO.h"
+#include "StreamBuffer.h"
+#include "Frustum.h"
 
 class Camera
 {
@@ -32,7 +34,8 @@ public:
     void UpdateMatrix(float FOVdeg, float nearPlane, float farPlane);
     void Inputs(GLFWwindow* window, float ElapseTime);
 
-    void BindUBO() const;
+    // The block lives in a stream buffer, it is written again on every bind
+    void BindUBO();
 
 public:
     void SetPosition(glm::vec3 position) { this->position = position; }
@@ -47,7 +50,9 @@ public:
     glm::vec3 GetOrientation() const { return this->Orientation; }
     glm::vec3 GetUp() const { return this->up; }
     glm::mat4 GetMatrix() const { return this->camMatrix; }
+    Frustum GetFrustum() const { return Frustum(this->camMatrix); }
     glm::mat4 GetViewMatrix() const { return glm::lookAt(this->position, this->position + this->Orientation, this->up); }
+    glm::mat4 GetProjectionMatrix() const { return glm::perspective(glm::radians(this->FOV), (float)(*this->width) / *this->height, this->nearPlane, this->farPlane); }
     bool IsWireframe() const { return this->isWireframe; }
     float GetFOV() const { return this->FOV; }
     float GetNearPlane() const { return this->nearPlane; }
@@ -75,7 +80,7 @@ private:
 
     bool firstClick = true;
 
-    UBO bUBO;
+    StreamBuffer bUBO;
     bool isWireframe = false;
 
 private:
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Camera.h"
+#include "ComputeShader.h"
+#include "SSBO.h"
+#include "StreamBuffer.h"
+#include "UBO.h"
+
+// Must match res/shader/light_cull.comp and res/shader/default.frag
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+#define CLUSTER_MAX_LIGHTS 128
+
+// Clustered forward shading: the view frustum is cut in CLUSTER_GRID_X x
+// CLUSTER_GRID_Y screen tiles and CLUSTER_GRID_Z exponential depth slices. A
+// compute pass bins the lights of the light SSBO into every cluster their range
+// touches, and the fragment shader only loops over the list of its own cluster.
+// Directional and ambient lights have no range and land in every cluster.
+class ClusteredLighting
+{
+public:
+    ClusteredLighting() = default;
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    bool Initialize();
+    void Destroy();
+
+    // Expects the lights bound at LIGHT_BINDING_POINT, leaves the cluster lists bound for the draws
+    void Cull(const Camera& camera);
+
+private:
+    struct alignas(16) ClusterBlock
+    {
+        glm::mat4 view;
+        glm::mat4 inverseProjection;
+        glm::vec4 planes; // near, far
+    };
+
+    ComputeShader cullShader;
+    StreamBuffer clusterBlock;
+    SSBO lightGrid;    // Light count per cluster
+    SSBO lightIndices; // CLUSTER_MAX_LIGHTS slots per cluster, extra lights are dropped
+};
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Shader.h"
+
+class ComputeShader
+{
+public:
+    ComputeShader() = default;
+    ComputeShader(const char* computePath);
+    ~ComputeShader();
+
+    ComputeShader(const ComputeShader&) = delete;
+    ComputeShader& operator=(const ComputeShader&) = delete;
+
+    ComputeShader(ComputeShader&&) noexcept;
+    ComputeShader& operator=(ComputeShader&&) noexcept;
+
+    bool SetShader(const char* computePath);
+    bool SetShaderCode(const std::string& computeCode);
+
+    void Bind() const;
+    void Unbind() const;
+    // Binds the program then dispatches, callers place their own memory barrier
+    void Dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ) const;
+    void Destroy();
+
+    GLuint GetID() const { return this->ID; }
+    bool IsCompiled() const { return this->ID != 0; }
+
+private:
+    GLuint ID = 0;
+};
\ No newline at end of file
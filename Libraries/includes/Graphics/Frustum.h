@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+// Planes of a view-projection matrix (Gribb & Hartmann), normals point inside
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes;
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection) {
+        for (int i = 0; i < 3; i++) {
+            glm::vec4 row(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+            glm::vec4 w(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+            this->planes[i * 2] = w + row;
+            this->planes[i * 2 + 1] = w - row;
+        }
+        for (glm::vec4& plane : this->planes) {
+            plane = plane / glm::length(glm::vec3(plane));
+        }
+    }
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : this->planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
\ No newline at end of file
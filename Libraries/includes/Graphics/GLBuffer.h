@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+#define BUFFER_GROWTH_FACTOR 2
+
+// Growth policy shared by the buffer wrappers: capacities grow geometrically so
+// a series of small resizes only reallocates O(log n) times, and the content is
+// preserved on the GPU with glCopyBufferSubData, never read back.
+class GLBuffer
+{
+private:
+    GLBuffer() = delete;
+    ~GLBuffer() = delete;
+
+public:
+    static size_t GrowCapacity(size_t capacity, size_t required);
+    // Replaces buffer by a new one of newCapacity bytes holding its first copySize bytes.
+    // The name changes: bindings and VAOs pointing to the old buffer must be redone.
+    static bool Reallocate(GLuint& buffer, size_t copySize, size_t newCapacity, GLenum usage);
+};
\ No newline at end of file
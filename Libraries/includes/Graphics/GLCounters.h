@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#define PIPELINE_QUERY_LATENCY 3
+// The frame being counted plus the PIPELINE_QUERY_LATENCY frames still in flight
+#define PIPELINE_QUERY_FRAMES (PIPELINE_QUERY_LATENCY + 1)
+#define PIPELINE_QUERY_COUNT 4
+
+struct GLFrameCounters
+{
+    uint32_t drawCalls = 0;    // API calls, a multi draw counts once
+    uint32_t drawCommands = 0; // Draws inside those calls
+    uint64_t triangles = 0;
+    uint64_t uploadBytes = 0;  // CPU to GPU buffer writes
+    uint32_t dispatches = 0;
+    uint32_t stateBinds = 0;   // Every bind GLState issued
+    uint32_t programSwitches = 0;
+    uint32_t textureBinds = 0;
+
+    // From GL_ARB_pipeline_statistics_query, PIPELINE_QUERY_LATENCY frames late
+    bool pipelineValid = false;
+    uint64_t primitivesSubmitted = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t fragmentInvocations = 0;
+    uint64_t clippedPrimitives = 0;
+};
+
+// Per frame counters of the GL work. Draw and upload sites report to it,
+// binds come from GLState. BeginFrame closes the previous frame, which is
+// then readable through GetLastFrame until the next BeginFrame.
+class GLCounters
+{
+private:
+    GLCounters() = delete;
+    ~GLCounters() = delete;
+
+public:
+    static void CountDraw(uint64_t triangles, uint32_t commands = 1) {
+        Data& data = GetData();
+        data.current.drawCalls++;
+        data.current.drawCommands += commands;
+        data.current.triangles += triangles;
+    }
+    static void CountUpload(size_t bytes) { GetData().current.uploadBytes += bytes; }
+    static void CountDispatch() { GetData().current.dispatches++; }
+
+    // Pipeline statistics cost a few queries per frame, they stay off unless asked for
+    static void EnablePipelineStatistics(bool enable);
+    static bool IsPipelineStatisticsEnabled() { return GetData().pipelineEnabled; }
+
+    static void BeginFrame();
+    static const GLFrameCounters& GetLastFrame() { return GetData().last; }
+    static void Destroy();
+
+private:
+    struct PipelineFrame
+    {
+        GLuint queries[PIPELINE_QUERY_COUNT] = {};
+        bool pending = false;
+    };
+
+    struct Data
+    {
+        GLFrameCounters current;
+        GLFrameCounters last;
+
+        bool pipelineEnabled = false;
+        bool pipelineActive = false;
+        uint64_t frame = 0;
+        PipelineFrame pipeline[PIPELINE_QUERY_FRAMES];
+        GLFrameCounters pipelineResult;
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+
+    static bool SupportsPipelineStatistics();
+    static void EndPipelineQueries();
+    static void ReadPipelineQueries(PipelineFrame& frame);
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+#define GLSTATE_TEXTURE_UNITS 32
+#define GLSTATE_BUFFER_BINDINGS 16
+#define GLSTATE_UNKNOWN 0xFFFFFFFFu
+
+struct GLStateStats
+{
+    uint32_t issued = 0;
+    uint32_t skipped = 0;
+    uint32_t programs = 0; // Issued program switches
+    uint32_t textures = 0; // Issued texture binds
+};
+
+// Shadow copy of the GL bindings, every wrapper goes through it so a call that
+// would not change anything is skipped. The element buffer binding belongs to
+// the VAO, it is forgotten whenever the VAO changes. Code that talks to GL
+// directly must call Invalidate afterwards.
+class GLState
+{
+private:
+    GLState() = delete;
+    ~GLState() = delete;
+
+public:
+    static void UseProgram(GLuint program);
+    static void BindVertexArray(GLuint vao);
+    static void BindBuffer(GLenum target, GLuint buffer);
+    static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    // Always issued: the shadow only tracks names, not ranges
+    static void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    static void BindFramebuffer(GLenum target, GLuint framebuffer);
+    static void ActiveTexture(GLenum texture);
+    static void BindTexture(GLenum target, GLuint texture);
+    static void PolygonMode(GLenum face, GLenum mode);
+    static void Enable(GLenum capability);
+    static void Disable(GLenum capability);
+
+    // GL unbinds deleted objects, the shadow state has to follow
+    static void DeleteProgram(GLuint program);
+    static void DeleteVertexArrays(GLsizei count, const GLuint* arrays);
+    static void DeleteBuffers(GLsizei count, const GLuint* buffers);
+    static void DeleteFramebuffers(GLsizei count, const GLuint* framebuffers);
+    static void DeleteTextures(GLsizei count, const GLuint* textures);
+
+    static void Invalidate();
+    // Compares the shadow state with glGet*, logs and fixes any mismatch
+    static bool Validate();
+
+    // Called once per frame: publishes the counters and, in debug, validates
+    static void BeginFrame();
+    static const GLStateStats& GetFrameStats() { return GetData().lastFrame; }
+
+private:
+    struct Data
+    {
+        GLuint program;
+        GLuint vao;
+        GLuint buffers[7];
+        GLuint uniformBuffers[GLSTATE_BUFFER_BINDINGS];
+        GLuint storageBuffers[GLSTATE_BUFFER_BINDINGS];
+        GLuint drawFramebuffer;
+        GLuint readFramebuffer;
+        GLuint activeTexture;
+        GLuint textures[GLSTATE_TEXTURE_UNITS];
+        GLuint polygonMode;
+        GLuint capabilities[4];
+        // Indexed bindings the context has, queried by the first Validate
+        GLuint uniformBindingCount;
+        GLuint storageBindingCount;
+
+        GLStateStats frame;
+        GLStateStats lastFrame;
+    };
+
+    static Data& GetData() {
+        static Data data = []() {
+            Data d {};
+            Reset(d);
+            return d;
+        }();
+        return data;
+    }
+
+    static void Reset(Data& data);
+    static int BufferSlot(GLenum target);
+    static int CapabilitySlot(GLenum capability);
+    static GLuint* IndexedSlot(GLenum target, GLuint index);
+    static bool Set(GLuint& shadow, GLuint value);
+};
\ No newline at end of file
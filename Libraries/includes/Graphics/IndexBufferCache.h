@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "EBO.h"
+#include "GridTopology.h"
+
+struct IndexBuffer
+{
+    EBO ebo;
+    GLsizei count = 0;
+};
+
+// One GL index buffer per topology, shared by every mesh that uses it.
+// The cache only keeps weak references: the buffer is deleted with its last user.
+class IndexBufferCache
+{
+public:
+    static std::shared_ptr<IndexBuffer> Acquire(const IndexBufferKey& key, const std::function<std::vector<GLuint>()>& generate);
+
+    static size_t GetBufferCount();
+    static void Purge();
+
+private:
+    static std::unordered_map<IndexBufferKey, std::weak_ptr<IndexBuffer>, IndexBufferKeyHash>& GetCache() {
+        static std::unordered_map<IndexBufferKey, std::weak_ptr<IndexBuffer>, IndexBufferKeyHash> cache;
+        return cache;
+    }
+};
\ No newline at end of file
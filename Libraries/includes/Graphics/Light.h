@@ -2,11 +2,19 @@
 
 #include "glm/glm.hpp"
 
+#include <cmath>
 #include <vector>
 
+#include "Frustum.h"
 #include "SSBO.h"
+#include "StreamBuffer.h"
 #include "UBO.h"
 
+// Intensity under which a light is ignored, must match LIGHT_CUTOFF in light_cull.comp
+#define LIGHT_CUTOFF 0.01f
+// Clean lights re-uploaded to merge two dirty runs instead of issuing another copy
+#define LIGHT_UPLOAD_MAX_GAP 4
+
 namespace lght
 {
     enum LightType { NONE, AMBIENT, DIRECTIONAL, POINT, SPOT };
@@ -222,6 +230,19 @@ namespace lght
         light.strength = strength;
         return light;
     }
+
+    // Distance where the attenuation drops below LIGHT_CUTOFF, same as lightRange
+    // in light_cull.comp. -1 means the light reaches everything, 0 nothing.
+    inline float Range(const Light& light) {
+        if (light.type == AMBIENT || light.type == DIRECTIONAL) return -1.0f;
+        if (light.type != POINT && light.type != SPOT) return 0.0f;
+        if (light.a <= 0.0f && light.b <= 0.0f) return -1.0f;
+
+        float k = light.strength / LIGHT_CUTOFF - 1.0f;
+        if (k <= 0.0f) return 0.0f;
+        if (light.a <= 0.0f) return k / light.b;
+        return (-light.b + std::sqrt(light.b * light.b + 4.0f * light.a * k)) / (2.0f * light.a);
+    }
 };
 
 
@@ -242,7 +263,9 @@ public:
     void Destroy();
 
     void initSSBO();
+    // Without a frustum every light is uploaded, with one only those it can see
     void updateSSBO();
+    void updateSSBO(const Frustum& frustum);
     void BindSSBO() const;
 
     void AddLight(lght::Light Light);
@@ -261,10 +284,14 @@ public:
 
     lght::Light& GetLight(size_t index);
     std::vector<lght::Light>& GetLight();
+    size_t GetLightCount() const { return this->lLight.size(); }
+    size_t GetVisibleLightCount() const { return this->visible.size(); }
     lght::Light& GetAmbientLight();
 
 private:
     void Swap(LightManager& other);
+    void UploadLights(const Frustum* frustum);
+    void UploadRange(size_t begin, size_t end);
 
 private:
     std::vector<lght::Light> lLight;
@@ -272,6 +299,13 @@ private:
     int size = 0;
 
     SSBO LightSSBO;
+    // Changed blocks are written here and copied into LightSSBO on the GPU
+    StreamBuffer LightStaging;
+
+    // Indices of the lights packed in LightSSBO, in order
+    std::vector<size_t> visible;
+    std::vector<size_t> visibleScratch;
+    std::vector<lght::LightBlock> packed;
 
 private:
     std::vector<bool> LightChanged;
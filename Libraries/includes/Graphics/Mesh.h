@@ -2,18 +2,21 @@
 
 #include <vector>
 #include <array>
-#include <unordered_map>
 #include <string>
+#include <memory>
 
 #include "Logger.h"
 
 #include "VAO.h"
 #include "VBO.h"
 #include "EBO.h"
-#include "UBO.h"
+#include "IndexBufferCache.h"
+#include "VertexPool.h"
+#include "ObjectTransforms.h"
 #include "Texture.h"
 #include "Shader.h"
 #include "Camera.h"
+#include "RenderQueue.h"
 
 class Mesh
 {
@@ -34,31 +37,44 @@ public:
     void Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices, std::vector<GLuint> sizeAttrib);
     void Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices, std::vector<GLuint> sizeAttrib,
                     std::vector<GLfloat> instances, std::vector<GLuint> SizeAttribInstance);
+    void Initialize(std::vector<GLfloat> vertices, std::shared_ptr<IndexBuffer> indexBuffer, std::vector<GLuint> sizeAttrib);
     void Destroy();
 
     void AddTexture(Texture texture);
     void AddTexture(const char* image, const char* name, GLenum format, GLenum pixelType);
-    void SetShader(Shader& shader) { this->shader = std::move(shader); }
-    void SetShaderCopy(const Shader& shader) { this->shader = Shader(shader); }
-    void SetShader(const char* vertexPath, const char* fragmentPath) { this->shader.SetShader(vertexPath, fragmentPath); }
+    void SetShader(Shader& shader) { this->shader = std::move(shader); this->samplersAssigned = false; }
+    void SetShaderCopy(const Shader& shader) { this->shader = Shader(shader); this->samplersAssigned = false; }
+    void SetShader(const char* vertexPath, const char* fragmentPath) { this->shader.SetShader(vertexPath, fragmentPath); this->samplersAssigned = false; }
     void SetPosition(glm::vec3 position) { this->position = position; }
     void SetScale(glm::vec3 scale) { this->scale = scale; }
     void SetRotation(glm::vec3 rotation) { this->rotation = rotation; }
 
-    void UpdateUBO();
+    void UpdateTransform();
     
-    void InitUniform4f(const char* uniform, const GLfloat* data);
-    void InitUniform3f(const char* uniform, const GLfloat* data);
-    void InitUniform2f(const char* uniform, const GLfloat* data);
-    void InitUniform1f(const char* uniform, const GLfloat* data);
-    void InitUniform4i(const char* uniform, const GLint* data);
-    void InitUniform3i(const char* uniform, const GLint* data);
-    void InitUniform2i(const char* uniform, const GLint* data);
-    void InitUniform1i(const char* uniform, const GLint* data);
-    void InitUniformMatrix4f(const char* uniform, const GLfloat* data);
-
-    void Render(Camera& camera);
-    void Draw(bool wireframe = false) const;
+    // Resolve the name once, then set through the handle: no lookup nor allocation per set.
+    // Handles stay valid when the shader changes, the location is fetched again lazily.
+    UniformHandle GetUniformHandle(const char* uniform);
+    void SetUniform4f(UniformHandle handle, const GLfloat* data);
+    void SetUniform3f(UniformHandle handle, const GLfloat* data);
+    void SetUniform2f(UniformHandle handle, const GLfloat* data);
+    void SetUniform1f(UniformHandle handle, const GLfloat* data);
+    void SetUniform4i(UniformHandle handle, const GLint* data);
+    void SetUniform3i(UniformHandle handle, const GLint* data);
+    void SetUniform2i(UniformHandle handle, const GLint* data);
+    void SetUniform1i(UniformHandle handle, const GLint* data);
+    void SetUniformMatrix4f(UniformHandle handle, const GLfloat* data);
+
+    void InitUniform4f(const char* uniform, const GLfloat* data) { this->SetUniform4f(this->GetUniformHandle(uniform), data); }
+    void InitUniform3f(const char* uniform, const GLfloat* data) { this->SetUniform3f(this->GetUniformHandle(uniform), data); }
+    void InitUniform2f(const char* uniform, const GLfloat* data) { this->SetUniform2f(this->GetUniformHandle(uniform), data); }
+    void InitUniform1f(const char* uniform, const GLfloat* data) { this->SetUniform1f(this->GetUniformHandle(uniform), data); }
+    void InitUniform4i(const char* uniform, const GLint* data) { this->SetUniform4i(this->GetUniformHandle(uniform), data); }
+    void InitUniform3i(const char* uniform, const GLint* data) { this->SetUniform3i(this->GetUniformHandle(uniform), data); }
+    void InitUniform2i(const char* uniform, const GLint* data) { this->SetUniform2i(this->GetUniformHandle(uniform), data); }
+    void InitUniform1i(const char* uniform, const GLint* data) { this->SetUniform1i(this->GetUniformHandle(uniform), data); }
+    void InitUniformMatrix4f(const char* uniform, const GLfloat* data) { this->SetUniformMatrix4f(this->GetUniformHandle(uniform), data); }
+
+    void Submit(RenderQueue& queue, const Camera& camera);
 
     glm::vec3& GetPosition() { return this->position; }
     glm::vec3& GetScale() { return this->scale; }
@@ -67,9 +83,12 @@ public:
 private:
     std::vector<GLfloat> vertices;
     std::vector<GLuint> indices;
+    std::shared_ptr<IndexBuffer> sharedIndices;
+    GLsizei indexCount = 0;
     std::vector<GLuint> sizeAttrib;
     std::vector<Texture> textures;
     Shader shader;
+    bool samplersAssigned = false; // Sampler uniforms are program state, set once
     
     glm::vec3 position = glm::vec3(0.0f);
     glm::vec3 scale = glm::vec3(1.0f);
@@ -80,21 +99,26 @@ private:
     std::vector<GLuint> SizeAttribInstance;
     
     VAO bVAO;
-    UBO bUBO;
+    // Meshes with a shared index buffer live in a vertex pool instead of bVAO
+    std::shared_ptr<VertexPool> pool;
+    VertexRange poolRange;
+    uint32_t transformSlot = INVALID_TRANSFORM_SLOT;
 
 
 private:
     struct UniformCache {
         std::array<uint8_t, 64> data; // Up to mat4
-        size_t size;
+        uint8_t size;
         GLint location;
         GLuint shaderID;
+        std::string name;
 
         UniformCache() : data({0}), size(0), location(-2), shaderID(0) {}
     };
-    std::unordered_map<std::string, UniformCache> uniformCache {};
-    bool CacheUniform(const std::string& uniform, void* data, size_t size);
-    GLint CachedUniformLocation(const std::string& uniform);
+    std::vector<UniformCache> uniformCache {}; // Indexed by UniformHandle
+    UniformHandle wireframeUniform = INVALID_UNIFORM_HANDLE;
+    GLint CacheUniform(UniformHandle handle, const void* data, size_t size);
     void FreeCache();
+    void Build(const EBO& ebo);
     void Swap(Mesh& other) noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SSBO.h"
+#include "StreamBuffer.h"
+#include "UBO.h"
+
+#define DRAW_ID_ATTRIBUTE_LOCATION 7
+#define INVALID_TRANSFORM_SLOT 0xFFFFFFFFu
+#define OBJECT_TRANSFORM_INITIAL_SLOTS 64
+
+// Model matrices of every mesh, in one SSBO at OBJECT_TRANSFORM_BINDING_POINT.
+// GL 4.3 has no gl_BaseInstance, so the shader gets its slot from an instanced
+// uint attribute (DRAW_ID_ATTRIBUTE_LOCATION, divisor 1). The attribute reads
+// the draw ID buffer at baseInstance, which the render queue sets to the
+// command index of each indirect draw.
+class ObjectTransforms
+{
+private:
+    ObjectTransforms() = delete;
+    ~ObjectTransforms() = delete;
+
+public:
+    static uint32_t Allocate();
+    static void Free(uint32_t slot);
+    static void Set(uint32_t slot, const glm::mat4& model);
+
+    // Stages the dirty slots, copies them into the SSBO on the GPU and binds it
+    static void Upload();
+    // One slot per indirect command, read through the draw ID attribute
+    static void UploadDrawIDs(const std::vector<GLuint>& slots);
+    // Attaches the draw ID buffer to the VAO currently bound
+    static void LinkDrawID();
+
+    static void Destroy();
+
+    static size_t GetSlotCount() { return GetData().models.size() - GetData().freeSlots.size(); }
+
+private:
+    struct Data
+    {
+        SSBO ssbo;
+        StreamBuffer staging;
+        GLuint drawIDBuffer = 0;
+        size_t drawIDCapacity = 0;
+        std::vector<glm::mat4> models;
+        std::vector<uint32_t> freeSlots;
+        size_t dirtyBegin = 0;
+        size_t dirtyEnd = 0;
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Shader.h"
+#include "Texture.h"
+
+#define RENDER_QUEUE_TEXTURE_UNITS 16
+
+class Mesh;
+
+struct DrawItem
+{
+    uint64_t key = 0;
+    GLuint program = 0;
+    GLuint vao = 0;
+    const Texture* textures = nullptr;
+    GLuint textureCount = 0;
+    GLsizei indexCount = 0;
+    GLint baseVertex = 0;
+    GLsizei instanceCount = 1;
+    uint32_t transformSlot = 0;
+    Mesh* mesh = nullptr; // Owner, used for the wireframe uniform
+    UniformHandle wireframeUniform = INVALID_UNIFORM_HANDLE;
+};
+
+// Layout fixed by GL for glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+struct RenderQueueStats
+{
+    uint32_t items = 0;
+    uint32_t drawCalls = 0;
+    uint32_t programBinds = 0;
+    uint32_t vaoBinds = 0;
+    uint32_t textureBinds = 0;
+
+    uint32_t GetStateChanges() const { return this->programBinds + this->vaoBinds + this->textureBinds; }
+};
+
+// Draw items are collected during the frame, sorted by key and executed in one go.
+// Binds are only issued when the state actually differs from the previous item.
+// Consecutive items sharing program, textures and VAO become one
+// glMultiDrawElementsIndirect; each command's baseInstance is its index, which
+// the draw ID attribute turns into the item's transform slot.
+//
+// Key layout (most significant first):
+//   16 bits program | 16 bits texture set | 16 bits VAO | 16 bits depth
+// Fields are folded to 16 bits, so two objects may share a key: this only affects
+// grouping, the executed binds always compare the real GL names.
+class RenderQueue
+{
+public:
+    RenderQueue() = default;
+    ~RenderQueue() { this->Destroy(); }
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    void Submit(const DrawItem& item);
+    void Flush(bool wireframe = false);
+    void Clear();
+    void Destroy();
+
+    static uint64_t MakeSortKey(const DrawItem& item, float depth);
+
+    size_t GetItemCount() const { return this->items.size(); }
+    // Counters of the last Flush
+    const RenderQueueStats& GetStats() const { return this->stats; }
+
+private:
+    struct Batch
+    {
+        uint32_t item;          // First item, its state is bound for the whole batch
+        uint32_t firstCommand;
+        uint32_t commandCount;  // 0 for instanced items, drawn on their own
+    };
+
+    void BuildBatches();
+    void UploadCommands();
+    void ResetState();
+    void BindState(const DrawItem& item);
+    void Execute(const Batch& batch);
+
+    static bool SameState(const DrawItem& a, const DrawItem& b);
+
+private:
+    std::vector<DrawItem> items;
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    std::vector<Batch> batches;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<GLuint> drawIDs;
+    RenderQueueStats stats;
+
+    GLuint indirectBuffer = 0;
+    size_t indirectCapacity = 0;
+
+    GLuint boundProgram = 0;
+    GLuint boundVAO = 0;
+    GLuint boundTextures[RENDER_QUEUE_TEXTURE_UNITS] = {};
+};
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 
 #include "Logger.h"
+#include "GLBuffer.h"
 
 #include <stdexcept>
 #include <vector>
@@ -35,8 +36,10 @@ public:
     void UploadData(const void* data, size_t size, size_t offset = 0);
     void DownloadData(void* data, size_t size, size_t offset = 0) const;
 
+    // Sizes only reallocate when they outgrow the capacity, which grows geometrically
     void Resize(size_t newSize);
     void ResizePreserveData(size_t newSize);
+    void Reserve(size_t newCapacity);
 
     void Bind() const;
     void BindToPoint() const;
@@ -48,6 +51,7 @@ public:
 
     GLuint getBufferID() const { return ID; }
     size_t getSize() const { return size; }
+    size_t getCapacity() const { return capacity; }
     GLuint getBindingPoint() const { return bindingPoint; }
     Usage getUsage() const { return usage; }
 
@@ -59,11 +63,13 @@ public:
 private:
     void Swap(SSBO& other) noexcept;
     void ensureCapacity(size_t requiredSize);
+    void Reallocate(size_t newCapacity, bool preserve);
 
 private:
     GLuint ID = 0;
     GLuint bindingPoint;
     size_t size;
+    size_t capacity = 0;
     Usage usage;
 
 };
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include <fstream>
 #include <sstream>
 #include <cerrno>
+#include <cstdint>
+
+// Index of a uniform resolved once by name, see Mesh::GetUniformHandle
+using UniformHandle = uint16_t;
+#define INVALID_UNIFORM_HANDLE 0xFFFF
 
 std::string get_file_contents(const char* filename);
 
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#define STREAM_BUFFER_FRAMES 3
+#define STREAM_BUFFER_INVALID_OFFSET SIZE_MAX
+
+// Buffer for data rewritten every frame (camera block, text quads, staged
+// uploads). It holds STREAM_BUFFER_FRAMES regions: the CPU writes into the
+// region of the current frame while the GPU still reads the previous ones, and
+// a fence per frame makes sure a region is free again before it is reused.
+// With GL 4.4 the buffer is created with glBufferStorage and stays persistently
+// mapped, a write is a plain memcpy. Older contexts map each allocation
+// unsynchronized instead, the fences give the same guarantee.
+//
+// Data written in a frame is only valid during that frame: anything bound from
+// this buffer must be written again each frame it is used.
+class StreamBuffer
+{
+public:
+    StreamBuffer() = default;
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    StreamBuffer(StreamBuffer&& other) noexcept;
+    StreamBuffer& operator=(StreamBuffer&& other) noexcept;
+
+    // target is where the data will be read from, it sets the offset alignment
+    bool Initialize(GLenum target, size_t frameSize);
+    void Destroy();
+
+    // Copies data into the current region and returns its offset in the buffer.
+    // The buffer grows when the region is full, its ID changes in that case.
+    // The old buffer stays alive for the ranges already bound from it and is
+    // deleted once the GPU is done with the frame that replaced it.
+    size_t Write(const void* data, size_t size);
+    // Writes data then copies it into dst on the GPU, in command order
+    bool Stage(const void* data, size_t size, GLuint dst, size_t dstOffset);
+    void BindRange(GLuint bindingPoint, size_t offset, size_t size) const;
+
+    bool isInitialized() const { return this->ID != 0; }
+    bool IsPersistent() const { return this->mapped != nullptr; }
+    GLuint GetID() const { return this->ID; }
+    size_t GetFrameSize() const { return this->frameSize; }
+
+    // Called once per frame around the rendering: BeginFrame waits until the
+    // region about to be reused is no longer read, EndFrame fences the frame.
+    static void BeginFrame();
+    static void EndFrame();
+    static void DestroyFences();
+
+private:
+    void Swap(StreamBuffer& other) noexcept;
+    bool Allocate(size_t frameSize);
+    void DeleteRetired(bool all);
+
+    static bool SupportsPersistentMapping();
+
+    struct Frames
+    {
+        GLsync fences[STREAM_BUFFER_FRAMES] = {};
+        uint64_t frame = 0;
+    };
+
+    static Frames& GetFrames() {
+        static Frames frames;
+        return frames;
+    }
+
+private:
+    GLuint ID = 0;
+    GLenum target = GL_ARRAY_BUFFER;
+    GLuint alignment = 16;
+    size_t frameSize = 0;
+    void* mapped = nullptr;
+
+    uint64_t frame = UINT64_MAX; // Frame the head belongs to
+    size_t head = 0;             // Offset inside the current region
+
+    struct Retired
+    {
+        GLuint ID;
+        uint64_t frame; // Frame it was replaced in
+    };
+    std::vector<Retired> retired; // Replaced while a frame was in progress
+};
\ No newline at end of file
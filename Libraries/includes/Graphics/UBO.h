@@ -4,13 +4,17 @@
 #define CAMERA_BINDING_POINT 0
 #define LIGHT_BINDING_POINT 1
 #define SKYBOX_BINDING_POINT 2
-#define MESH_MODEL_BINDING_POINT 3
+#define OBJECT_TRANSFORM_BINDING_POINT 3 // SSBO
+#define CLUSTER_BINDING_POINT 4
+#define LIGHT_GRID_BINDING_POINT 5 // SSBO
+#define LIGHT_INDEX_BINDING_POINT 6 // SSBO
 
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include "Logger.h"
+#include "GLBuffer.h"
 
 #include <vector>
 
@@ -34,7 +38,14 @@ public:
     void BindToBindingPoint() const;
     void Unbind() const;
 
-    void uploadData(const void* data, size_t size, size_t offset = 0) const;
+    // Grows the buffer when the data does not fit, see Reserve
+    void uploadData(const void* data, size_t size, size_t offset = 0);
+    // Geometric growth, the content is kept with a GPU copy and the binding point updated
+    void Resize(size_t newSize);
+    void Reserve(size_t newCapacity);
+
+    size_t getSize() const { return this->size; }
+    size_t getCapacity() const { return this->capacity; }
 
     /*
     access :
@@ -47,11 +58,13 @@ public:
 
 private:
     void Swap(UBO& other) noexcept;
+    void Reallocate(size_t newCapacity);
 
 
 private:
     GLuint ID = 0;
     GLuint bindingPoint;
     size_t size;
+    size_t capacity = 0;
     GLenum usage;
 };
\ No newline at end of file
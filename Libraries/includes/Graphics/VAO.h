@@ -23,6 +23,8 @@ public:
     void Unbind() const;
     void Destroy();
 
+    GLuint GetID() const { return this->ID; }
+
 private:
     GLuint ID = 0;
 };
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <glad/glad.h>
 #include <vector>
 
+#include "GLBuffer.h"
+
 class VBO
 {
 public:
@@ -23,9 +25,21 @@ public:
     void Unbind() const;
     void Destroy();
 
+    // Geometric growth with a GPU copy of the content. The buffer name changes,
+    // VAOs using it have to link their attributes again.
+    void Resize(size_t newSize);
+    void Reserve(size_t newCapacity);
+
+    GLuint GetID() const { return this->ID; }
+    size_t GetSize() const { return this->size; }
+    size_t GetCapacity() const { return this->capacity; }
+
 protected:
     void Swap(VBO& other) noexcept;
 
 protected:
     GLuint ID = 0;    
+    size_t size = 0;
+    size_t capacity = 0;
+    GLenum usage = GL_STATIC_DRAW;
 };
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <vector>
+
+#include "BufferArena.h"
+#include "IndexBufferCache.h"
+#include "VAO.h"
+
+#define VERTEX_POOL_INITIAL_VERTICES 65536
+
+struct VertexRange
+{
+    GLint baseVertex = 0;
+    GLsizei count = 0;
+};
+
+// Vertex storage shared by every mesh with the same layout and index buffer.
+// They all draw through one VAO with a base vertex, so the render queue can
+// batch them into a single multi-draw. The storage is a BufferArena aligned on
+// the vertex stride, so every range starts on a whole vertex.
+class VertexPool
+{
+public:
+    VertexPool(const std::vector<GLuint>& sizeAttrib, std::shared_ptr<IndexBuffer> indices);
+    ~VertexPool();
+
+    VertexPool(const VertexPool&) = delete;
+    VertexPool& operator=(const VertexPool&) = delete;
+
+    static std::shared_ptr<VertexPool> Acquire(const std::vector<GLuint>& sizeAttrib, const std::shared_ptr<IndexBuffer>& indices);
+
+    bool Allocate(const std::vector<GLfloat>& vertices, VertexRange& range);
+    void Free(const VertexRange& range);
+
+    GLuint GetVAO() const { return this->vao.GetID(); }
+    GLsizei GetIndexCount() const { return this->indices->count; }
+    size_t GetCapacity() const { return this->arena.GetCapacity() / this->GetStride(); } // In vertices
+
+private:
+    void LinkAttributes();
+    size_t GetStride() const { return this->floatsPerVertex * sizeof(GLfloat); }
+
+    static std::vector<std::weak_ptr<VertexPool>>& GetPools() {
+        static std::vector<std::weak_ptr<VertexPool>> pools;
+        return pools;
+    }
+
+private:
+    std::vector<GLuint> sizeAttrib;
+    GLuint floatsPerVertex = 0;
+    std::shared_ptr<IndexBuffer> indices;
+
+    VAO vao;
+    BufferArena arena;
+    GLuint linkedBuffer = 0; // Arena buffer the VAO points to
+};
\ No newline at end of file
@@ -116,9 +116,11 @@ public:
     double GetMinElapseTimeSecond() const { return this->fpsCounter.getMinElapseTimeInSeconds(); }
 
     double GetElapseTimeMillisecond() const { return this->fpsCounter.getElapseTimeInMilliseconds(); }
+    std::chrono::nanoseconds GetElapseTime() const { return this->fpsCounter.getElapseTime(); }
     double GetAverageElapseTimeMillisecond() const { return this->fpsCounter.getAverageElapseTimeInMilliseconds(); }
     double GetMaxElapseTimeMillisecond() const { return this->fpsCounter.getMaxElapseTimeInMilliseconds(); }
     double GetMinElapseTimeMillisecond() const { return this->fpsCounter.getMinElapseTimeInMilliseconds(); }
+    double GetFrameTimePercentileMillisecond(double p) const { return this->fpsCounter.getFrameTimePercentileInMilliseconds(p); }
 
 
 private:
@@ -6,7 +6,19 @@
 #include <array>
 #include <functional>
 
+#include "GridTopology.h"
+#include "Heightfield.h"
+
+#ifndef HEADLESS
 #include "Mesh.h"
+#include "IndexBufferCache.h"
+#endif
+
+// Scratch budget of one tile of the fused kernel, sized to stay in L2
+#define FUSED_TILE_BYTES (256 * 1024)
+// Below this the multi-pass pipeline runs from cache and is faster, see terrain-cli --benchmark-kernel
+#define FUSED_MIN_POINTS (2048u * 2048u)
+#define FLOATS_PER_VERTEX 9
 
 struct Vertex
 {
@@ -30,29 +42,54 @@ public:
     void GeneratePoints();
     void GenerateTriangles();
     void GenerateNormals();
+#ifndef HEADLESS
     void GenerateMesh();
+#endif
+
+    static std::vector<unsigned int> GenerateIndices(unsigned int resolution_x, unsigned int resolution_z, uint8_t lod = 0, uint8_t stitch = STITCH_NONE);
+    static void ForEachTriangle(unsigned int resolution_x, unsigned int resolution_z, uint8_t lod, uint8_t stitch,
+                                const std::function<void(unsigned int, unsigned int, unsigned int)>& func);
 
     void TransformPoints(std::function<void(Vertex&, unsigned int)> func);
+    // Single pass over the grid: func, normals and packing are done tile by tile
+    void TransformPointsFused(const std::function<void(Vertex&, unsigned int)>& func, bool packVertices = true);
+    void PackVertices(std::vector<float>& out) const;
 
-    void Render(Camera& camera);
+#ifndef HEADLESS
+    void Submit(RenderQueue& queue, const Camera& camera);
+#endif
 
-    unsigned int GetResolutionX() { return this->resolution_x; }
-    unsigned int GetResolutionY() { return this->resolution_z; }
-    std::vector<Vertex> GetPoints() { return this->points; }
-    std::vector<std::array<unsigned int, 3>> GetTriangles() { return this->triangles; }
+    unsigned int GetResolutionX() const { return this->resolution_x; }
+    unsigned int GetResolutionY() const { return this->resolution_z; }
+    float GetSizeX() const { return this->size_x; }
+    float GetSizeZ() const { return this->size_z; }
+    const std::vector<Vertex>& GetPoints() const { return this->points; }
+    std::vector<std::array<unsigned int, 3>> GetTriangles();
+#ifndef HEADLESS
     Mesh& GetMesh() { return this->mesh; }
+#endif
+    const Heightfield& GetHeightfield() const { return this->heightfield; }
 
+    void SetTopologyVariant(uint8_t lod, uint8_t stitch) { this->lod = lod; this->stitch = stitch; }
+    IndexBufferKey GetTopologyKey() const { return { this->resolution_x, this->resolution_z, this->lod, this->stitch }; }
 
-    unsigned int GetPointCount() { return this->points.size(); }
-    unsigned int GetTriangleCount() { return this->triangles.size(); }
+    unsigned int GetPointCount() const { return this->points.size(); }
+    // Triangles of the topology variant the mesh is built with
+    unsigned int GetTriangleCount() const;
 
 private:
     float size_x;
     float size_z;
     unsigned int resolution_x;
     unsigned int resolution_z;
+    uint8_t lod = 0;
+    uint8_t stitch = STITCH_NONE;
     std::vector<Vertex> points;
     std::vector<std::array<unsigned int, 3>> triangles;
+    std::vector<float> packedVertices; // Filled by TransformPointsFused, consumed by GenerateMesh
+    Heightfield heightfield;
 
+#ifndef HEADLESS
     Mesh mesh;
+#endif
 };
\ No newline at end of file
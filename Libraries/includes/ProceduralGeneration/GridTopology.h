@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// Edges of a grid patch that must match a neighbour one LOD coarser
+enum StitchEdge : uint8_t {
+    STITCH_NONE = 0,
+    STITCH_NEG_X = 1 << 0,
+    STITCH_POS_X = 1 << 1,
+    STITCH_NEG_Z = 1 << 2,
+    STITCH_POS_Z = 1 << 3
+};
+
+struct IndexBufferKey
+{
+    unsigned int resolution_x;
+    unsigned int resolution_z;
+    uint8_t lod = 0;
+    uint8_t stitch = STITCH_NONE;
+
+    bool operator==(const IndexBufferKey& other) const {
+        return resolution_x == other.resolution_x &&
+               resolution_z == other.resolution_z &&
+               lod == other.lod &&
+               stitch == other.stitch;
+    }
+};
+
+struct IndexBufferKeyHash
+{
+    size_t operator()(const IndexBufferKey& key) const noexcept {
+        uint64_t packed = (static_cast<uint64_t>(key.resolution_x) << 40) ^
+                          (static_cast<uint64_t>(key.resolution_z) << 16) ^
+                          (static_cast<uint64_t>(key.lod) << 8) ^
+                          key.stitch;
+        return std::hash<uint64_t>()(packed);
+    }
+};
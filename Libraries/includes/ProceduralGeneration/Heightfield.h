@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct Vertex;
+
+struct RayHit
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    float distance;
+};
+
+// Read-only height queries over a grid, with a min/max pyramid for ray casts
+class Heightfield
+{
+public:
+    Heightfield() = default;
+
+    void Build(const std::vector<Vertex>& points, unsigned int resolution_x, unsigned int resolution_z, float size_x, float size_z);
+    void Clear();
+
+    // Bilinear height, clamped to the grid borders
+    float HeightAt(float x, float z) const;
+    void HeightsAt(const std::vector<glm::vec2>& positions, std::vector<float>& heights) const;
+
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayHit& hit) const;
+
+    bool IsEmpty() const { return this->heights.empty(); }
+    float GetMinHeight() const { return this->pyramid.empty() ? 0.0f : this->pyramid.back().minMax[0].x; }
+    float GetMaxHeight() const { return this->pyramid.empty() ? 0.0f : this->pyramid.back().minMax[0].y; }
+
+private:
+    struct Level
+    {
+        unsigned int width;
+        unsigned int depth;
+        std::vector<glm::vec2> minMax; // x = min, y = max
+    };
+
+    float Height(unsigned int i, unsigned int j) const { return this->heights[i * this->resolution_z + j]; }
+    glm::vec3 Point(unsigned int i, unsigned int j) const;
+    bool IntersectNode(const glm::vec3& origin, const glm::vec3& invDirection, unsigned int level, unsigned int i, unsigned int j, float maxDistance, float& tEnter) const;
+    bool IntersectCell(const glm::vec3& origin, const glm::vec3& direction, unsigned int i, unsigned int j, float maxDistance, RayHit& hit) const;
+
+private:
+    unsigned int resolution_x = 0;
+    unsigned int resolution_z = 0;
+    float origin_x = 0.0f;
+    float origin_z = 0.0f;
+    float step_x = 1.0f;
+    float step_z = 1.0f;
+
+    std::vector<float> heights;
+    std::vector<Level> pyramid; // pyramid[0] holds one entry per cell
+};
\ No newline at end of file
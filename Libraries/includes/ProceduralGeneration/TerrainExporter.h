@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Grid;
+
+#define EXPORT_ROW_BLOCK 64
+
+#define MESH_FILE_MAGIC 0x48534D50 // "PMSH"
+#define MESH_FILE_VERSION 1
+
+// Header of the binary mesh format, followed by vertexCount * 9 float32
+// (position, normal, color) then indexCount indices of indexSize bytes.
+// All values are little-endian.
+struct MeshFileHeader
+{
+    uint32_t magic = MESH_FILE_MAGIC;
+    uint32_t version = MESH_FILE_VERSION;
+    uint32_t resolution_x = 0;
+    uint32_t resolution_z = 0;
+    uint32_t vertexCount = 0;
+    uint32_t floatsPerVertex = 9;
+    uint32_t indexCount = 0;
+    uint32_t indexSize = 4; // 2 when every index fits in 16 bits
+};
+
+// Heightmaps are written one grid x row per image row (width = resolution_z,
+// height = resolution_x). 16-bit formats map [min, max] height to [0, 65535].
+// Every exporter works on blocks of EXPORT_ROW_BLOCK rows, so memory use does
+// not depend on the grid size.
+class TerrainExporter
+{
+public:
+    static bool ExportRAW32(const Grid& grid, const std::string& path);
+    static bool ExportRAW16(const Grid& grid, const std::string& path);
+    static bool ExportPNG16(const Grid& grid, const std::string& path);
+    static bool ExportMesh(const Grid& grid, const std::string& path);
+
+private:
+    static uint16_t Quantize(float height, float minHeight, float maxHeight);
+};
\ No newline at end of file
@@ -19,7 +19,9 @@ public:
     void Destroy();
 
     void init(float sizeX, float sizeZ, int resX, int resZ);
-    void Render(Camera& camera);
+#ifndef HEADLESS
+    void Submit(RenderQueue& queue, const Camera& camera);
+#endif
 
 
     // Terrain Generation
@@ -37,12 +39,22 @@ public:
 
 
     Grid& GetGrid() { return grid; }
+#ifndef HEADLESS
     Mesh& GetMesh() { return grid.GetMesh(); }
+#endif
 
-    void SetNoiseSeed(int seed) { noise.SetSeed(seed); }
+    void SetNoiseSeed(uint64_t seed) { noise.SetSeed(seed); }
+    // World-space offset of the grid center, used to sample adjacent tiles
+    void SetOrigin(glm::vec2 origin) { this->origin = origin; }
     
 
+private:
+    // Fused pipeline from FUSED_MIN_POINTS points, multi-pass below
+    void Transform(const std::function<void(Vertex&, unsigned int)>& func);
+    void UploadMesh();
+
 private:
     Grid grid;
     Noise noise;
+    glm::vec2 origin = glm::vec2(0.0f);
 };
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "LockFreeRing.h"
+#include "ProfileZones.h"
+
+#define ALLOC_TRACKER_MAX_THREADS 64
+#define ALLOC_TRACKER_ZONE_DEPTH 64
+#define ALLOC_TRACKER_NO_ZONE PROFILE_ZONE_MAX_IDS
+#define ALLOC_TRACKER_MAX_SITES 512
+#define ALLOC_TRACKER_STACK_DEPTH 16
+#define ALLOC_TRACKER_SKIP_FRAMES 2
+#define ALLOC_REPORT_WARMUP_FRAMES 120
+#define ALLOC_REPORT_DEFAULT_FRAMES 300
+#define ALLOC_REPORT_TOP_SITES 32
+
+struct AllocationCounters
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+};
+
+// Counts every operator new per thread and per innermost PROFILE_SCOPE zone.
+// The hook replaces the global operator new/delete and is only compiled with
+// TRACK_ALLOCATIONS (make TRACK_ALLOCATIONS=1), without it every counter
+// stays at zero.
+// A report watches the steady state: after ALLOC_REPORT_WARMUP_FRAMES frames
+// it records the call stack of each allocation for a number of frames, then
+// writes the zones and call sites that allocated under GetUserDataPath()/allocations.
+// With a budget, the report also says whether the worst frame went over it.
+class AllocationTracker
+{
+private:
+    AllocationTracker() = delete;
+    ~AllocationTracker() = delete;
+
+    AllocationTracker(const AllocationTracker&) = delete;
+    AllocationTracker& operator=(const AllocationTracker&) = delete;
+    AllocationTracker(AllocationTracker&&) = delete;
+    AllocationTracker& operator=(AllocationTracker&&) = delete;
+
+public:
+    static constexpr bool IsEnabled() {
+#ifdef TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Called by the hook, must not allocate
+    static void RecordAllocation(size_t bytes) noexcept;
+    static void RecordFree() noexcept;
+
+    // Called by ProfileZones::Begin/End, allocations go to the innermost zone
+    static void EnterZone(ProfileZoneID id) noexcept;
+    static void LeaveZone() noexcept;
+
+    // budget < 0 reports without a budget
+    static void StartReport(uint32_t frames, int64_t budget = -1);
+    static bool IsReportDone() { return GetData().reportDone; }
+    static bool IsOverBudget() { return GetData().overBudget; }
+
+    // Main thread, once per frame. Closes the previous frame
+    static void BeginFrame();
+    static const AllocationCounters& GetLastFrame() { return GetData().last; }
+    static AllocationCounters GetThreadTotal(size_t thread);
+    static size_t GetThreadCount();
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Counters
+    {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> frees{0};
+    };
+
+    struct Site
+    {
+        void* stack[ALLOC_TRACKER_STACK_DEPTH] = {};
+        int depth = 0;
+        uint64_t hash = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct Data
+    {
+        Counters threads[ALLOC_TRACKER_MAX_THREADS];
+        std::atomic<uint32_t> threadCount{0};
+        std::atomic<uint64_t> zoneAllocations[PROFILE_ZONE_MAX_IDS + 1] = {};
+        std::atomic<uint64_t> zoneBytes[PROFILE_ZONE_MAX_IDS + 1] = {};
+
+        // Call sites, only filled while a report records
+        std::atomic<bool> capturing{false};
+        std::atomic_flag sitesLock = ATOMIC_FLAG_INIT;
+        Site sites[ALLOC_TRACKER_MAX_SITES];
+        uint32_t siteCount = 0;
+        uint64_t droppedSites = 0;
+
+        // Main thread
+        AllocationCounters total;
+        AllocationCounters last;
+        uint64_t frame = 0;
+
+        uint32_t reportFrames = 0;
+        uint32_t reportFramesLeft = 0;
+        int64_t budget = -1;
+        bool reportDone = false;
+        bool overBudget = false;
+        AllocationCounters reportTotal;
+        uint64_t reportWorstFrame = 0;
+        uint64_t reportWorstFrameIndex = 0;
+        // Totals when the window opens, replaced by the window deltas when it closes
+        uint64_t zoneAllocationsBase[PROFILE_ZONE_MAX_IDS + 1] = {};
+        uint64_t zoneBytesBase[PROFILE_ZONE_MAX_IDS + 1] = {};
+        AllocationCounters threadsBase[ALLOC_TRACKER_MAX_THREADS];
+    };
+
+    // Constant initialized, usable before any static constructor has run
+    static Data& GetData() {
+        static constinit Data data;
+        return data;
+    }
+
+    static Counters& GetThreadCounters() noexcept;
+    static void RecordSite(size_t bytes) noexcept;
+    static void WriteReport();
+};
\ No newline at end of file
@@ -66,6 +66,9 @@ public:
     double getMinElapseTimeInMicroseconds() const noexcept { return this->minElapseTimens * 1e-3; }
     double getMinElapseTimeInNanoseconds() const noexcept { return this->minElapseTimens; }
 
+    // Full frame time (sleep included) over the last PercentileWindow frames, p in [0, 100]
+    double getFrameTimePercentileInMilliseconds(double p) const noexcept { return this->frameTimeBuffer.GetPercentile(p).count() * 1e-6; }
+
     // Performance metrics
     double getSleepAccuracy() const noexcept { return this->sleepAccuracy; }
     int64_t getTotalFramesDropped() const noexcept { return this->framesDropped; }
@@ -115,6 +118,8 @@ private:
     static const int BufferSize = 30;
     RingBuffer<double> fpsBuffer;
     RingBuffer<double> elapseTimeBuffer;
+    static const int PercentileWindow = 1000;
+    RingBuffer<std::chrono::nanoseconds> frameTimeBuffer;
     
     // Platform-specific data
 #ifdef _WIN32
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Frames between issuing a timestamp and reading it back
+#define GPU_TIMER_LATENCY 3
+// The slot of the current frame plus the GPU_TIMER_LATENCY frames still in flight
+#define GPU_TIMER_FRAMES (GPU_TIMER_LATENCY + 1)
+#define GPU_TIMER_MAX_ZONES 64
+#define GPU_TIMER_INVALID_ZONE UINT32_MAX
+
+struct GPUTimerResult
+{
+    uint16_t name;
+    uint16_t depth;
+    uint64_t frame;
+    std::chrono::nanoseconds start; // GPU clock
+    std::chrono::nanoseconds end;
+};
+
+// Timestamp queries for GPU zones, allocated once and reused. Each frame owns
+// GPU_TIMER_MAX_ZONES pairs of queries in a ring of GPU_TIMER_FRAMES frames:
+// when a frame slot comes back around, GPU_TIMER_LATENCY frames after it was
+// issued, its results are read in one pass, so the CPU never waits on the GPU.
+// Zones nest freely since timestamps are absolute.
+class GPUTimers
+{
+private:
+    GPUTimers() = delete;
+    ~GPUTimers() = delete;
+
+    GPUTimers(const GPUTimers&) = delete;
+    GPUTimers& operator=(const GPUTimers&) = delete;
+    GPUTimers(GPUTimers&&) = delete;
+    GPUTimers& operator=(GPUTimers&&) = delete;
+
+public:
+    static uint32_t Begin(const std::string& name);
+    static void End(uint32_t zone);
+
+    // Reads back the frame slot about to be reused, then moves to the next
+    // frame. The results stay valid until the next call.
+    static const std::vector<GPUTimerResult>& NewFrame();
+    // Results of the last NewFrame
+    static const std::vector<GPUTimerResult>& GetResults() { return GetData().results; }
+    static void Destroy();
+
+    static const std::string& GetName(uint16_t name);
+    static uint64_t GetDroppedFrames() { return GetData().dropped; }
+    static uint64_t GetFrame() { return GetData().frame; }
+
+private:
+    struct Zone
+    {
+        uint16_t name;
+        uint16_t depth;
+        bool ended;
+    };
+
+    struct Frame
+    {
+        GLuint queries[GPU_TIMER_MAX_ZONES * 2] = {};
+        Zone zones[GPU_TIMER_MAX_ZONES] = {};
+        uint32_t count = 0;
+        uint64_t frame = 0;
+        GLuint last = 0; // Last timestamp issued, the others are done when it is
+    };
+
+    struct Data
+    {
+        Frame frames[GPU_TIMER_FRAMES];
+        uint64_t frame = 0;
+        uint16_t depth = 0;
+        bool initialized = false;
+        uint64_t dropped = 0;
+
+        std::vector<std::string> names;
+        std::unordered_map<std::string, uint16_t> nameIDs;
+        std::vector<GPUTimerResult> results;
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+
+    static void Initialize();
+    static void Resolve(Frame& frame);
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ProfileZones.h"
+#include "GPUTimers.h"
+#include "RingBuffer.h"
+
+#define HITCH_DEFAULT_THRESHOLD 2.5f
+#define HITCH_HISTORY_FRAMES 8
+#define HITCH_MEDIAN_WINDOW 240
+#define HITCH_MEDIAN_REFRESH 10
+#define HITCH_MIN_FRAMES 60
+#define HITCH_COOLDOWN_FRAMES 120
+
+// Per frame counters kept with each frame, filled by the caller
+struct HitchCounters
+{
+    uint32_t glIssued = 0;
+    uint32_t glSkipped = 0;
+    uint32_t drawCalls = 0;
+    uint32_t stateChanges = 0;
+    uint64_t triangles = 0;
+    uint64_t uploadBytes = 0;
+    uint32_t programSwitches = 0;
+    uint32_t textureBinds = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+};
+
+// Flags frames slower than threshold times the rolling median frame time and
+// writes what led to them under GetUserDataPath()/hitches: zone trees, GPU
+// zones and counters of the hitch and the HITCH_HISTORY_FRAMES frames before,
+// and the log lines of that window. GPU zones are the ones resolved during a
+// frame, tagged with the frame that issued them. Frames are copied into
+// preallocated slots, nothing is allocated or written while no hitch happens.
+// Main thread only, call NewFrame after Profiler::Process.
+class HitchDetector
+{
+private:
+    HitchDetector() = delete;
+    ~HitchDetector() = delete;
+
+    HitchDetector(const HitchDetector&) = delete;
+    HitchDetector& operator=(const HitchDetector&) = delete;
+    HitchDetector(HitchDetector&&) = delete;
+    HitchDetector& operator=(HitchDetector&&) = delete;
+
+public:
+    // 0 disables the detector
+    static void SetThreshold(float threshold) { GetData().threshold = threshold; }
+    static float GetThreshold() { return GetData().threshold; }
+    static uint64_t GetHitchCount() { return GetData().hitches; }
+
+    static void NewFrame(std::chrono::nanoseconds frameTime, const HitchCounters& counters);
+
+private:
+    struct FrameRecord
+    {
+        uint64_t frame = 0;
+        std::chrono::nanoseconds frameTime{0};
+        std::chrono::system_clock::time_point time;
+        HitchCounters counters;
+        uint64_t gpuFrame = 0; // GPUTimers::GetFrame() when recorded, dates the resolved GPU zones
+        std::vector<std::vector<ProfileZoneNode>> threads;
+        std::vector<GPUTimerResult> gpu;
+    };
+
+    struct Data
+    {
+        float threshold = HITCH_DEFAULT_THRESHOLD;
+        uint64_t frame = 0;
+        uint64_t lastHitch = 0;
+        uint64_t hitches = 0;
+        std::chrono::nanoseconds median{0};
+        RingBuffer<std::chrono::nanoseconds> frameTimes{HITCH_MEDIAN_WINDOW};
+        FrameRecord records[HITCH_HISTORY_FRAMES + 1];
+
+        Data() { this->frameTimes.EnablePercentiles(); }
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+
+    static void Record(FrameRecord& record, std::chrono::nanoseconds frameTime, const HitchCounters& counters);
+    static std::string WriteSnapshot(const FrameRecord& hitch);
+};
\ No newline at end of file
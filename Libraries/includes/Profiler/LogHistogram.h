@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Sub-buckets per power of two are 2^(bits - 1), 6 bits keeps every bucket within ~3%
+#define HISTOGRAM_PRECISION_BITS 6
+#define HISTOGRAM_HALF_RANGE (uint64_t(1) << (HISTOGRAM_PRECISION_BITS - 1))
+#define HISTOGRAM_BUCKETS (HISTOGRAM_HALF_RANGE * (64 - HISTOGRAM_PRECISION_BITS + 2))
+
+// HDR style histogram over unsigned values: exact under 2^bits, then a fixed
+// number of linear sub-buckets per power of two. Adding, removing and asking
+// for a percentile do not depend on how many values were added.
+class LogHistogram
+{
+public:
+    LogHistogram() noexcept { this->Clear(); }
+
+    void Add(uint64_t value) noexcept {
+        this->counts[Index(value)]++;
+        this->count++;
+    }
+
+    void Remove(uint64_t value) noexcept {
+        uint32_t& bucket = this->counts[Index(value)];
+        if (bucket == 0) return;
+        bucket--;
+        this->count--;
+    }
+
+    void Clear() noexcept {
+        this->counts.fill(0);
+        this->count = 0;
+    }
+
+    [[nodiscard]] uint64_t GetCount() const noexcept { return this->count; }
+
+    // Highest value of the bucket holding the p-th percentile, p in [0, 100]
+    [[nodiscard]] uint64_t GetPercentile(double p) const noexcept {
+        if (this->count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(this->count)));
+        rank = std::min(std::max(rank, uint64_t(1)), this->count);
+
+        // Tail percentiles are found faster from the top
+        if (rank > this->count / 2) {
+            uint64_t above = this->count - rank;
+            uint64_t seen = 0;
+            for (size_t i = HISTOGRAM_BUCKETS; i-- > 0;) {
+                seen += this->counts[i];
+                if (seen > above) return UpperValue(i);
+            }
+        } else {
+            uint64_t seen = 0;
+            for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+                seen += this->counts[i];
+                if (seen >= rank) return UpperValue(i);
+            }
+        }
+        return 0;
+    }
+
+private:
+    static size_t Index(uint64_t value) noexcept {
+        if (value < HISTOGRAM_HALF_RANGE * 2) return static_cast<size_t>(value);
+        const int shift = (63 - std::countl_zero(value)) - (HISTOGRAM_PRECISION_BITS - 1);
+        return static_cast<size_t>(HISTOGRAM_HALF_RANGE * shift + (value >> shift));
+    }
+
+    static uint64_t UpperValue(size_t index) noexcept {
+        if (index < HISTOGRAM_HALF_RANGE * 2) return index;
+        const uint64_t shift = index / HISTOGRAM_HALF_RANGE - 1;
+        const uint64_t mantissa = index - HISTOGRAM_HALF_RANGE * shift;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    std::array<uint32_t, HISTOGRAM_BUCKETS> counts;
+    uint64_t count = 0;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RingBuffer.h"
+#include "LockFreeRing.h"
+
+#define PROFILE_ZONE_MAX_IDS 256
+#define PROFILE_ZONE_INVALID_ID UINT16_MAX
+#define PROFILE_ZONE_THREAD_EVENTS 16384
+#define PROFILE_ZONE_HISTORY 128
+#define PROFILE_ZONE_NO_NODE UINT32_MAX
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+
+// Times the enclosing scope. The name is interned once per call site, after
+// that a zone costs two clock reads and two writes into the thread's buffer.
+#define PROFILE_SCOPE(name) \
+    static const ProfileZoneID PROFILE_ZONE_CONCAT(profileZoneID_, __LINE__) = ProfileZones::Intern(name); \
+    ProfileScope PROFILE_ZONE_CONCAT(profileScope_, __LINE__)(PROFILE_ZONE_CONCAT(profileZoneID_, __LINE__))
+
+using ProfileZoneID = uint16_t;
+
+// Node of the zone tree of one thread for the last collected frame. Calls of
+// the same zone under the same parent are merged into one node, node 0 is the
+// root of the thread and holds no zone.
+struct ProfileZoneNode
+{
+    ProfileZoneID id = PROFILE_ZONE_INVALID_ID;
+    uint32_t parent = PROFILE_ZONE_NO_NODE;
+    uint32_t firstChild = PROFILE_ZONE_NO_NODE;
+    uint32_t nextSibling = PROFILE_ZONE_NO_NODE;
+    uint32_t calls = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds self{0}; // total minus the time spent in children
+};
+
+// Hierarchical CPU zones. Every thread records begin/end events into its own
+// single producer ring, no lock is taken on that path. Collect, called once per
+// frame by the main thread, drains the rings, rebuilds the zone trees and
+// keeps a history of total and self time per zone.
+class ProfileZones
+{
+private:
+    ProfileZones() = delete;
+    ~ProfileZones() = delete;
+
+    ProfileZones(const ProfileZones&) = delete;
+    ProfileZones& operator=(const ProfileZones&) = delete;
+    ProfileZones(ProfileZones&&) = delete;
+    ProfileZones& operator=(ProfileZones&&) = delete;
+
+public:
+    // Same name, same ID. name must outlive the program (string literal)
+    static ProfileZoneID Intern(const char* name);
+    static ProfileZoneID Find(const char* name);
+    static const char* GetName(ProfileZoneID id);
+
+    static void Begin(ProfileZoneID id) noexcept;
+    static void End() noexcept;
+
+    static void Collect();
+
+    // Main thread only, valid until the next Collect
+    static size_t GetThreadCount();
+    static const std::vector<ProfileZoneNode>& GetFrameTree(size_t thread);
+    static std::thread::id GetThreadID(size_t thread);
+
+    static std::chrono::nanoseconds GetAverageTotalTime(const char* name);
+    static std::chrono::nanoseconds GetAverageSelfTime(const char* name);
+    static std::chrono::nanoseconds GetPercentileTotalTime(const char* name, double p);
+    static uint64_t GetDroppedEvents();
+
+    // Clock of the zone timestamps, in nanoseconds
+    static int64_t Now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    struct Event
+    {
+        int64_t time;
+        ProfileZoneID id;
+        bool begin;
+    };
+
+    struct OpenZone
+    {
+        ProfileZoneID id;
+        uint32_t node;
+        int64_t start;
+        int64_t childTime;
+    };
+
+    struct ThreadState
+    {
+        std::thread::id threadID;
+
+        // Written by the owning thread, read by Collect
+        SPSCRing<Event, PROFILE_ZONE_THREAD_EVENTS> events;
+        uint32_t depth = 0;     // Owner only, recorded zones still open
+        uint32_t skipDepth = 0; // Owner only, zones dropped while the ring was full
+        std::atomic<bool> exited{false}; // Set as the owner exits, after its last event
+
+        // Under Data::mutex, set by Collect once an exited state is drained
+        bool reusable = false;
+
+        // Collect only
+        std::vector<OpenZone> open;
+        std::vector<ProfileZoneNode> tree;
+    };
+
+    struct ZoneStats
+    {
+        RingBuffer<std::chrono::nanoseconds> total{PROFILE_ZONE_HISTORY};
+        RingBuffer<std::chrono::nanoseconds> self{PROFILE_ZONE_HISTORY};
+        std::chrono::nanoseconds frameTotal{0};
+        std::chrono::nanoseconds frameSelf{0};
+        bool seen = false;
+
+        ZoneStats() { this->total.EnablePercentiles(); }
+    };
+
+    struct Data
+    {
+        std::mutex mutex; // Interning, thread registration and Collect
+        const char* names[PROFILE_ZONE_MAX_IDS] = {};
+        ProfileZoneID count = 0;
+        ZoneStats stats[PROFILE_ZONE_MAX_IDS];
+        std::vector<std::unique_ptr<ThreadState>> threads;
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+
+    static ThreadState& GetThreadState();
+    static void Drain(ThreadState& state, uint16_t thread);
+    static uint32_t FindOrAddChild(std::vector<ProfileZoneNode>& tree, uint32_t parent, ProfileZoneID id);
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(ProfileZoneID id) noexcept { ProfileZones::Begin(id); }
+    ~ProfileScope() noexcept { ProfileZones::End(); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
\ No newline at end of file
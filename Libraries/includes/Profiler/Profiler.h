@@ -1,21 +1,26 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <unordered_map>
 #include <functional>
-#include <mutex>
-#include <queue>
 #include <vector>
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include "RingBuffer.h"
+#include "LockFreeRing.h"
+#include "ProfileZones.h"
+#include "GPUTimers.h"
+#include "TraceCapture.h"
 
-#define MAX_QUERIES 12
 #define BUFFER_SIZE 512
 #define SAVE_HISTORY_EVERY_MS 3000
-#define QUERY_TIMEOUT_MS 10000
+#define PROFILER_SAMPLE_QUEUE 4096
 
+// CPU samples may come from any thread, they go through a lock-free queue
+// drained by Process. Process, the GPU zones and the getters belong to the
+// main thread, which is the only one touching the timers.
 class Profiler
 {
 private:
@@ -30,28 +35,29 @@ private:
 
 
 public:
-    static void Profile(std::string name, std::function<void()> func) {
+    // name must outlive the program (string literal)
+    static void Profile(const char* name, std::function<void()> func) {
         auto start = std::chrono::high_resolution_clock::now();
         func();
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        AddTime(name, duration);
+        RecordTime(name, duration);
     }
 
     template<typename Func, typename... Args>
-    static auto Profile(const std::string& name, Func&& func, Args&&... args) -> std::invoke_result_t<Func, Args...> {
+    static auto Profile(const char* name, Func&& func, Args&&... args) -> std::invoke_result_t<Func, Args...> {
         auto start = std::chrono::high_resolution_clock::now();
         
         if  constexpr (std::is_same_v<std::invoke_result_t<Func, Args...>, void>) {
             std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
             auto end = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-            AddTime(name, duration);
+            RecordTime(name, duration);
         } else {
             auto result = std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
             auto end = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-            AddTime(name, duration);
+            RecordTime(name, duration);
             
             return result;
         }
@@ -67,46 +73,36 @@ public:
         return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
     }
 
-    static void ProfileGPU(std::string name, std::function<void()> func) {
-        std::array<GLuint, 2> queries;
-        glGenQueries(2, queries.data());
-
-        glQueryCounter(queries[0], GL_TIMESTAMP);
+    static void ProfileGPU(const std::string& name, std::function<void()> func) {
+        const uint32_t zone = GPUTimers::Begin(name);
         func();
-        glQueryCounter(queries[1], GL_TIMESTAMP);
-
-        AddQuery(name, queries);
-
-        ProcessQueries(name);
+        GPUTimers::End(zone);
     }
 
     template <typename Func, typename... Args>
     static auto ProfileGPU(const std::string& name, Func&& func, Args&&... args) -> std::invoke_result_t<Func, Args...> {
-        std::array<GLuint, 2> queries;
-        glGenQueries(2, queries.data());
-
-        glQueryCounter(queries[0], GL_TIMESTAMP);
+        const uint32_t zone = GPUTimers::Begin(name);
         if constexpr (std::is_void_v<std::invoke_result_t<Func, Args...>>) {
             std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
-            glQueryCounter(queries[1], GL_TIMESTAMP);
-
-            AddQuery(name, queries);
-            ProcessQueries(name);
+            GPUTimers::End(zone);
         } else {
             auto result = std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
-            glQueryCounter(queries[1], GL_TIMESTAMP);
-
-            AddQuery(name, queries);
-            ProcessQueries(name);
-            
+            GPUTimers::End(zone);
             return result;
         }
     }
 
     static void Process() {
-        for (auto& [name, queriesData] : getQueryData()) {
-            ProcessQueries(name);
+        ProfileZones::Collect();
+
+        getSamples().Drain([](const Sample& sample) { AddTime(sample.name, sample.time); });
+
+        // GPU results come back GPU_TIMER_LATENCY frames late
+        for (const GPUTimerResult& result : GPUTimers::NewFrame()) {
+            AddTime(GPUTimers::GetName(result.name), result.end - result.start);
+            TraceCapture::AddGPUZone(result);
         }
+        TraceCapture::NewFrame();
 
         for (auto& [name, profilerData] : getProfilerData()) {
             auto now = std::chrono::high_resolution_clock::now();
@@ -132,39 +128,22 @@ public:
     static std::chrono::nanoseconds GetMinTime(std::string name) {
         return getTimer(name).GetMin();
     }
+    static uint64_t GetDroppedSamples() {
+        return getDroppedSamples().load(std::memory_order_relaxed);
+    }
+    // p in [0, 100], over the last BUFFER_SIZE samples
+    static std::chrono::nanoseconds GetPercentileTime(const std::string& name, double p) {
+        return getTimer(name).GetPercentile(p);
+    }
 
 private:
-    static void ProcessQueries(std::string name) {
-        while (!getQueries(name).empty()) {
-            GLint available;
-            std::array<GLuint, 2> q = getQueries(name).front();
-            glGetQueryObjectiv(q[1], GL_QUERY_RESULT_AVAILABLE, &available);
-            if (available == GL_TRUE) {
-                GLuint64 startTime, endTime;
-                glGetQueryObjectui64v(q[0], GL_QUERY_RESULT, &startTime);
-                glGetQueryObjectui64v(q[1], GL_QUERY_RESULT, &endTime);
-                
-                std::chrono::nanoseconds GPUTime = std::chrono::nanoseconds((endTime - startTime));
-
-                AddTime(name, GPUTime);
-                glDeleteQueries(1, &q[0]);
-                glDeleteQueries(1, &q[1]);
-                PopQuery(name);
-            } else {
-                auto now = std::chrono::high_resolution_clock::now();
-                if ((now - getQueryData()[name].lastUpdate) >= std::chrono::milliseconds(QUERY_TIMEOUT_MS)) {
-                    glDeleteQueries(1, &q[0]);
-                    glDeleteQueries(1, &q[1]);
-                    PopQuery(name);
-                } else {
-                    break;
-                }
-            }
+    static void RecordTime(const char* name, std::chrono::nanoseconds time) noexcept {
+        if (!getSamples().TryPush({ name, time })) {
+            getDroppedSamples().fetch_add(1, std::memory_order_relaxed);
         }
     }
 
-    static void AddTime(std::string name, std::chrono::nanoseconds time) {
-        std::lock_guard<std::mutex> lock(getProfilerMutex());
+    static void AddTime(const std::string& name, std::chrono::nanoseconds time) {
         getTimer(name).Push(time);
         auto now = std::chrono::high_resolution_clock::now();
         if ( getProfilerData()[name].history.size() == 0 || (now - getProfilerData()[name].history.back().time).count() >= SAVE_HISTORY_EVERY_MS) {
@@ -172,23 +151,6 @@ private:
         }
     }
 
-    static void AddQuery(std::string name, std::array<GLuint, 2> queries) {
-        std::lock_guard<std::mutex> lock(getQueryMutex()); 
-        if (getQueries(name).size() >= MAX_QUERIES) {
-            glDeleteQueries(2, getQueries(name).front().data());
-            getQueries(name).pop();
-        }
-        getQueries(name).push(queries); 
-        getQueryData()[name].lastUpdate = std::chrono::high_resolution_clock::now();
-    }
-
-    static void PopQuery(std::string name) { 
-        std::lock_guard<std::mutex> lock(getQueryMutex());
-        getQueries(name).pop();
-        getQueryData()[name].lastUpdate = std::chrono::high_resolution_clock::now();
-    }
-
-
     struct TimerData
     {
         std::chrono::high_resolution_clock::time_point time;
@@ -201,12 +163,8 @@ private:
     {
         RingBuffer<std::chrono::nanoseconds> buffer{BUFFER_SIZE};
         std::vector<TimerData> history;
-    };
 
-    struct QueryData
-    {
-        std::queue<std::array<GLuint, 2>> queries;
-        std::chrono::high_resolution_clock::time_point lastUpdate;
+        ProfilerData() { this->buffer.EnablePercentiles(); }
     };
 
     static std::unordered_map<std::string, ProfilerData>& getProfilerData() {
@@ -214,27 +172,23 @@ private:
         return profilerData;
     }
 
-    static std::unordered_map<std::string, QueryData>& getQueryData() {
-        static std::unordered_map<std::string, QueryData> queryData;
-        return queryData;
-    }
-
-    static RingBuffer<std::chrono::nanoseconds>& getTimer(std::string name) {
+    static RingBuffer<std::chrono::nanoseconds>& getTimer(const std::string& name) {
         return getProfilerData()[name].buffer;
     }
 
-    static std::queue<std::array<GLuint, 2>>& getQueries(std::string name) {
-        return getQueryData()[name].queries;
-    }
-
+    struct Sample
+    {
+        const char* name;
+        std::chrono::nanoseconds time;
+    };
 
-    static std::mutex& getProfilerMutex() {
-        static std::mutex mutex;
-        return mutex;
+    static MPSCRing<Sample, PROFILER_SAMPLE_QUEUE>& getSamples() {
+        static MPSCRing<Sample, PROFILER_SAMPLE_QUEUE> samples;
+        return samples;
     }
 
-    static std::mutex& getQueryMutex() {
-        static std::mutex mutex;
-        return mutex;
+    static std::atomic<uint64_t>& getDroppedSamples() {
+        static std::atomic<uint64_t> dropped{0};
+        return dropped;
     }
 };
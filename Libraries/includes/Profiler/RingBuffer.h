@@ -1,13 +1,21 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include "Logger.h"
+#include "LogHistogram.h"
 
 #define MIN_CAPACITY size_t(10)
 #define MAX_CAPACITY size_t(0x8000)
 #define DEFAULT_CAPACITY size_t(100)
 
+// Fixed window of the last pushed values. The sum, min and max of the window
+// are kept up to date on every push (running sum and monotonic queues), so
+// reading them is O(1). Percentiles are available once EnablePercentiles has
+// been called, they come from a log histogram of the window.
 template <typename Type>
 class RingBuffer
 {
@@ -25,61 +33,101 @@ public:
         this->Destroy();
     }
 
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    RingBuffer(RingBuffer&& other) noexcept {
+        this->Swap(other);
+    }
+
+    RingBuffer& operator=(RingBuffer&& other) noexcept {
+        if (this != &other) {
+            this->Destroy();
+            this->Swap(other);
+        }
+        return *this;
+    }
+
     void Init(size_t capacity) noexcept {
         capacity = std::min(std::max(capacity, MIN_CAPACITY), MAX_CAPACITY);
-        if (this->buffer != nullptr)
-            delete[] this->buffer;
+        this->Destroy();
         this->buffer = new Type[capacity]();
+        this->minQueue = new Entry[capacity]();
+        this->maxQueue = new Entry[capacity]();
         this->capacity = capacity;
-        this->size = 0;
-        this->index = 0;
     }
 
     void Destroy() noexcept
     {
-        if (this->buffer != nullptr) {
-            delete[] this->buffer;
-            this->buffer = nullptr;
-        }
+        delete[] this->buffer;
+        delete[] this->minQueue;
+        delete[] this->maxQueue;
+        this->buffer = nullptr;
+        this->minQueue = nullptr;
+        this->maxQueue = nullptr;
         this->capacity = 0;
-        this->size = 0;
-        this->index = 0;
+        this->ResetStats();
     }
 
     void Clear() noexcept {
-        if (this->size == 0) return;
+        this->ResetStats();
+    }
+
+    void EnablePercentiles() noexcept {
+        if (this->histogram) return;
+        this->histogram = std::make_unique<LogHistogram>();
         for (size_t i = 0; i < this->size; ++i) {
-            this->buffer[(this->index - i) % this->capacity] = Type();
+            this->histogram->Add(ToHistogram(this->Get(i)));
         }
-        this->size = 0;
-        this->index = 0;
     }
 
-
     void Push(Type value) noexcept
     {
+        if (this->capacity == 0) return;
+
         if (this->size < this->capacity) {
             ++this->size;
+        } else {
+            // The slot about to be overwritten holds the oldest value
+            const Type evicted = this->buffer[(this->index + 1) % this->capacity];
+            this->sum -= evicted;
+            if (this->histogram) this->histogram->Remove(ToHistogram(evicted));
         }
         this->index = (this->index + 1) % this->capacity;
         this->buffer[this->index] = value;
+
+        const uint64_t sequence = this->pushed++;
+        this->sum += value;
+        if (this->histogram) this->histogram->Add(ToHistogram(value));
+
+        // A floating point sum drifts, rebuilt once per window it stays O(1) amortized
+        if constexpr (std::is_floating_point_v<Type>) {
+            if (sequence % this->capacity == this->capacity - 1) this->RecomputeSum();
+        }
+
+        const uint64_t oldest = this->pushed - this->size;
+        PushQueue(this->minQueue, this->minHead, this->minCount, value, sequence, oldest, [](const Type& a, const Type& b) { return a >= b; });
+        PushQueue(this->maxQueue, this->maxHead, this->maxCount, value, sequence, oldest, [](const Type& a, const Type& b) { return a <= b; });
     }
 
     void Resize(size_t newCapacity) noexcept {
         newCapacity = std::min(std::max(newCapacity, MIN_CAPACITY), MAX_CAPACITY);
         if (newCapacity == this->capacity) return;
 
-        Type *newBuffer = new Type[newCapacity]();
+        // Oldest first so the statistics are rebuilt in order
         size_t copySize = std::min(this->size, newCapacity);
+        Type *values = new Type[copySize]();
         for (size_t i = 0; i < copySize; ++i) {
-            newBuffer[newCapacity - i - 1] = Get(i);
+            values[copySize - i - 1] = Get(i);
         }
 
-        delete[] this->buffer;
-        this->buffer = newBuffer;
-        this->capacity = newCapacity;
-        this->size = copySize;
-        this->index = (this->capacity - this->size) % this->capacity;
+        const bool percentiles = this->histogram != nullptr;
+        this->Init(newCapacity);
+        if (percentiles) this->EnablePercentiles();
+        for (size_t i = 0; i < copySize; ++i) {
+            this->Push(values[i]);
+        }
+        delete[] values;
     }
 
     [[nodiscard]] size_t GetCapacity() const noexcept
@@ -103,23 +151,10 @@ public:
     [[nodiscard]] Type GetAverage() const noexcept
     {
         if (this->size == 0) return Type();
-        if constexpr (
-            std::is_same_v<Type, std::chrono::nanoseconds> || 
-            std::is_same_v<Type, std::chrono::microseconds> || 
-            std::is_same_v<Type, std::chrono::milliseconds> || 
-            std::is_same_v<Type, std::chrono::seconds> || 
-            std::is_same_v<Type, std::chrono::minutes> || 
-            std::is_same_v<Type, std::chrono::hours>) 
-        {
-            using rep_t = long long;
-            rep_t sum_rep = this->Get(0).count();
-            for (size_t i = 1; i < this->size; ++i) {
-                sum_rep += this->Get(i).count();
-            }
-            return Type(sum_rep / static_cast<rep_t>(this->size));
+        if constexpr (IsDuration) {
+            return Type(this->sum.count() / static_cast<typename Type::rep>(this->size));
         } else if constexpr (std::is_arithmetic_v<Type>) {
-            Type sum = GetSum();
-            return sum / static_cast<Type>(this->size);
+            return this->sum / static_cast<Type>(this->size);
         }
         LOG_ERROR(-1, "Unsupported type");
         return Type();
@@ -127,46 +162,120 @@ public:
 
     [[nodiscard]] Type GetSum() const noexcept
     {
-        if (this->size == 0)
-            return Type();
-            
-        Type sum = this->Get(0);
-        for (size_t i = 1; i < this->size; i++) {
-            sum += this->Get(i);
-        }
-
-        return sum;
+        return this->size == 0 ? Type() : this->sum;
     };
 
     [[nodiscard]] Type GetMin() const noexcept
     {
         if (this->size == 0) return Type();
-        Type min = this->Get(0);
-        for (size_t i = 1; i < this->size; i++) {
-            if (this->Get(i) < min) {
-                min = this->Get(i);
-            }
-        }
-
-        return min;
+        return this->minQueue[this->minHead].value;
     };
 
     [[nodiscard]] Type GetMax() const noexcept
     {
         if (this->size == 0) return Type();
-        Type max = this->Get(0);
-        for (size_t i = 1; i < this->size; i++) {
-            if (this->Get(i) > max) {
-                max = this->Get(i);
-            }
+        return this->maxQueue[this->maxHead].value;
+    };
+
+    // p in [0, 100], Type() until EnablePercentiles is called
+    [[nodiscard]] Type GetPercentile(double p) const noexcept
+    {
+        if (!this->histogram || this->size == 0) return Type();
+        const uint64_t value = this->histogram->GetPercentile(p);
+        if constexpr (IsDuration) {
+            return Type(static_cast<typename Type::rep>(value));
+        } else {
+            return static_cast<Type>(value);
         }
+    };
+
+private:
+    static constexpr bool IsDuration =
+        std::is_same_v<Type, std::chrono::nanoseconds> ||
+        std::is_same_v<Type, std::chrono::microseconds> ||
+        std::is_same_v<Type, std::chrono::milliseconds> ||
+        std::is_same_v<Type, std::chrono::seconds> ||
+        std::is_same_v<Type, std::chrono::minutes> ||
+        std::is_same_v<Type, std::chrono::hours>;
 
-        return max;
+    struct Entry
+    {
+        Type value;
+        uint64_t sequence;
     };
 
+    static uint64_t ToHistogram(const Type& value) noexcept {
+        if constexpr (IsDuration) {
+            return value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+        } else {
+            return value > Type() ? static_cast<uint64_t>(value) : 0;
+        }
+    }
+
+    // Monotonic queue stored as a ring: entries no longer in the window leave
+    // from the front, entries the new value makes useless leave from the back
+    template <typename Dominates>
+    void PushQueue(Entry* queue, size_t& head, size_t& count, const Type& value, uint64_t sequence, uint64_t oldest, Dominates dominates) noexcept {
+        while (count > 0 && queue[head].sequence < oldest) {
+            head = (head + 1) % this->capacity;
+            --count;
+        }
+        while (count > 0 && dominates(queue[(head + count - 1) % this->capacity].value, value)) {
+            --count;
+        }
+        queue[(head + count) % this->capacity] = { value, sequence };
+        ++count;
+    }
+
+    void RecomputeSum() noexcept {
+        Type total = Type();
+        for (size_t i = 0; i < this->size; ++i) {
+            total += this->Get(i);
+        }
+        this->sum = total;
+    }
+
+    void ResetStats() noexcept {
+        this->size = 0;
+        this->index = 0;
+        this->pushed = 0;
+        this->sum = Type();
+        this->minHead = 0;
+        this->minCount = 0;
+        this->maxHead = 0;
+        this->maxCount = 0;
+        if (this->histogram) this->histogram->Clear();
+    }
+
+    void Swap(RingBuffer& other) noexcept {
+        std::swap(this->index, other.index);
+        std::swap(this->capacity, other.capacity);
+        std::swap(this->size, other.size);
+        std::swap(this->buffer, other.buffer);
+        std::swap(this->pushed, other.pushed);
+        std::swap(this->sum, other.sum);
+        std::swap(this->minQueue, other.minQueue);
+        std::swap(this->maxQueue, other.maxQueue);
+        std::swap(this->minHead, other.minHead);
+        std::swap(this->minCount, other.minCount);
+        std::swap(this->maxHead, other.maxHead);
+        std::swap(this->maxCount, other.maxCount);
+        std::swap(this->histogram, other.histogram);
+    }
+
 private:
     size_t index = 0;
     size_t capacity = 0;
     size_t size = 0;
     Type *buffer = nullptr;
+
+    uint64_t pushed = 0;
+    Type sum = Type();
+    Entry *minQueue = nullptr;
+    Entry *maxQueue = nullptr;
+    size_t minHead = 0;
+    size_t minCount = 0;
+    size_t maxHead = 0;
+    size_t maxCount = 0;
+    std::unique_ptr<LogHistogram> histogram;
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ProfileZones.h"
+#include "GPUTimers.h"
+
+#define TRACE_CAPTURE_MAX_EVENTS (size_t(1) << 19)
+#define TRACE_CALIBRATION_FRAMES 120
+#define TRACE_GPU_THREAD 1000
+
+// Records every CPU zone and resolved GPU zone into a bounded buffer and
+// writes them as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev).
+// GPU timestamps are moved onto the CPU clock with a GL_TIMESTAMP read taken
+// when the capture starts and every TRACE_CALIBRATION_FRAMES frames.
+// Main thread only, the CPU zones come in through ProfileZones::Collect.
+class TraceCapture
+{
+private:
+    TraceCapture() = delete;
+    ~TraceCapture() = delete;
+
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+    TraceCapture(TraceCapture&&) = delete;
+    TraceCapture& operator=(TraceCapture&&) = delete;
+
+public:
+    // frames = 0 records until Stop
+    static void Start(uint32_t frames = 0);
+    // Writes the capture under GetUserDataPath()/traces, returns the file or "" on failure
+    static std::string Stop();
+    static void Toggle();
+    static bool IsCapturing() { return GetData().capturing; }
+
+    static void AddCPUZone(ProfileZoneID id, uint16_t thread, int64_t start, int64_t end);
+    static void AddGPUZone(const GPUTimerResult& result);
+    // Counter track sample, name interned through ProfileZones
+    static void AddCounter(ProfileZoneID name, int64_t value);
+    static void NewFrame();
+
+private:
+    enum Source : uint8_t { CPU, GPU, FRAME, COUNTER };
+
+    struct Event
+    {
+        int64_t start;    // CPU clock, ns
+        int64_t duration; // Value for COUNTER
+        uint32_t frame;
+        uint16_t name;
+        uint16_t thread;
+        Source source;
+        uint8_t depth;
+    };
+
+    struct Data
+    {
+        bool capturing = false;
+        uint32_t framesLeft = 0;
+        uint32_t frame = 0;
+        int64_t startTime = 0;
+        int64_t gpuOffset = 0; // CPU minus GPU clock
+        uint64_t gpuFrameBase = 0;
+        uint64_t dropped = 0;
+        std::vector<Event> events;
+    };
+
+    static Data& GetData() {
+        static Data data;
+        return data;
+    }
+
+    static void Calibrate();
+    static void Push(const Event& event);
+};
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "StreamBuffer.h"
+
 namespace UI {
 
 // Forward declarations
@@ -144,13 +146,16 @@ private:
     std::string activeFontName;
 
     // OpenGL
-    unsigned int VAO, VBO;
+    unsigned int VAO;
+    StreamBuffer VBO;          // Glyph quads, rewritten every frame
+    unsigned int linkedVBO = 0; // Buffer the VAO points to, changes when VBO grows
     std::unique_ptr<Shader> shader;
     glm::mat4 projection;
     unsigned int screenWidth, screenHeight;
 
     // Méthodes privées
     void setupRenderData();
+    void linkVertexBuffer();
     Character loadCharacter(FT_Face face, char c);
     glm::vec2 calculateAnchorOffset(const std::string& text, float scale, TextAnchor anchor);
 
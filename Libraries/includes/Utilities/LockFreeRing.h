@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// std::hardware_destructive_interference_size warns under GCC, the value is 64 everywhere we run
+#define CACHE_LINE_SIZE 64
+
+// Bounded queue for one producer thread and one consumer thread. Capacity is a
+// power of two so positions wrap with a mask, head and tail sit on their own
+// cache lines and each side caches the other's position to avoid touching it
+// on every call.
+template <typename Type, size_t Capacity>
+class SPSCRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SPSCRing() = default;
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    // Producer
+    bool TryPush(const Type& value) noexcept {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head - this->cachedTail >= Capacity) {
+            this->cachedTail = this->tail.load(std::memory_order_acquire);
+            if (head - this->cachedTail >= Capacity) return false;
+        }
+        this->items[head & Mask] = value;
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer, never less than the real free space
+    size_t GetFreeSpace() noexcept {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        return Capacity - (head - this->cachedTail);
+    }
+
+    // Consumer
+    bool TryPop(Type& value) noexcept {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail == this->cachedHead) {
+            this->cachedHead = this->head.load(std::memory_order_acquire);
+            if (tail == this->cachedHead) return false;
+        }
+        value = std::move(this->items[tail & Mask]);
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer, hands every available item to func and releases them at once
+    template <typename Func>
+    size_t Drain(Func&& func) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        const size_t count = this->cachedHead - tail;
+        for (; tail != this->cachedHead; tail++) {
+            func(this->items[tail & Mask]);
+        }
+        this->tail.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate when called while the other side is working
+    size_t GetSize() const noexcept {
+        return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t GetCapacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t Mask = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+    alignas(CACHE_LINE_SIZE) Type items[Capacity];
+};
+
+// Bounded queue for any number of producer threads and one consumer. Each
+// slot carries a sequence number telling whether it is free for the position
+// a producer claimed or holds a value for the consumer (Vyukov's queue), so
+// producers only contend on one compare exchange of the head.
+template <typename Type, size_t Capacity>
+class MPSCRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MPSCRing() noexcept {
+        for (size_t i = 0; i < Capacity; i++) {
+            this->cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRing(const MPSCRing&) = delete;
+    MPSCRing& operator=(const MPSCRing&) = delete;
+
+    // Any thread
+    bool TryPush(const Type& value) noexcept {
+        return this->TryEmplace([&](Type& slot) { slot = value; });
+    }
+
+    bool TryPush(Type&& value) noexcept {
+        return this->TryEmplace([&](Type& slot) { slot = std::move(value); });
+    }
+
+    // Any thread, write fills the claimed slot in place so it can reuse what
+    // the slot already owns. The consumer waits on the slot until write returns
+    template <typename Write>
+    bool TryEmplace(Write&& write) noexcept {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &this->cells[head & Mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(head);
+            if (difference == 0) {
+                if (this->head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false; // Full, the consumer has not freed this slot yet
+            } else {
+                head = this->head.load(std::memory_order_relaxed);
+            }
+        }
+        write(cell->value);
+        cell->sequence.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer
+    bool TryPop(Type& value) noexcept {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        Cell& cell = this->cells[tail & Mask];
+        if (cell.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+
+        value = std::move(cell.value);
+        cell.sequence.store(tail + Capacity, std::memory_order_release);
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer, stops at the first slot a producer has claimed but not filled yet
+    template <typename Func>
+    size_t Drain(Func&& func) {
+        size_t count = 0;
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        for (;; tail++, count++) {
+            Cell& cell = this->cells[tail & Mask];
+            if (cell.sequence.load(std::memory_order_acquire) != tail + 1) break;
+            func(cell.value);
+            cell.sequence.store(tail + Capacity, std::memory_order_release);
+        }
+        this->tail.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    // Any thread. Once GetConsumed() reaches a value GetClaimed() returned,
+    // every push that claimed its slot before that call has been consumed
+    size_t GetClaimed() const noexcept { return this->head.load(std::memory_order_acquire); }
+    size_t GetConsumed() const noexcept { return this->tail.load(std::memory_order_acquire); }
+
+    // Approximate when called while producers are working
+    size_t GetSize() const noexcept {
+        const size_t head = this->head.load(std::memory_order_acquire);
+        const size_t tail = this->tail.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+    static constexpr size_t GetCapacity() noexcept { return Capacity; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Type value;
+    };
+
+    static constexpr size_t Mask = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    alignas(CACHE_LINE_SIZE) Cell cells[Capacity];
+};
\ No newline at end of file
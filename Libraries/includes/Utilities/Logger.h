@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <mutex>
@@ -7,6 +9,16 @@
 #include <fstream>
 #include <memory>
 #include <sstream>
+#include <string_view>
+
+#define LOGGER_QUEUE_CAPACITY 4096
+#define LOGGER_WRITER_INTERVAL_MS 5
+#define LOGGER_FILE_WRITE_MS 1000
+#define LOGGER_SAMPLE_RATE 16
+#define LOGGER_HISTORY_CAPACITY 1024 // Recent messages kept for duplicate folding, Print and GetLogsSince
+#define LOGGER_FILE_BUFFER_SIZE (64 * 1024)
+#define LOGGER_ROTATE_BYTES (16 * 1024 * 1024)
+#define LOGGER_ROTATE_FILES 5
 
 enum LogLevel {
 #ifdef DEBUG
@@ -20,6 +32,22 @@ enum LogLevel {
     L_FATAL
 };
 
+// What an async log call does when the writer thread is behind
+enum LogOverflowPolicy {
+    LOG_OVERFLOW_BLOCK,  // Wait for a free slot, nothing is lost
+    LOG_OVERFLOW_DROP,   // Drop the message when the queue is full
+    LOG_OVERFLOW_SAMPLE  // Past half full keep one in LOGGER_SAMPLE_RATE messages below L_WARNING, warnings and errors wait
+};
+
+// Synchronous by default: the calling thread folds duplicates and prints under
+// logMutex. After StartAsync, callers only format the message into a slot of
+// a lock-free queue and a writer thread does the folding, console output and
+// file writes, every LOGGER_WRITER_INTERVAL_MS or sooner when the queue fills.
+// L_FATAL always waits for a slot and for the writer before exiting.
+// Only the last LOGGER_HISTORY_CAPACITY messages are kept in memory. The log
+// file is written through a LOGGER_FILE_BUFFER_SIZE buffer, emptied when full,
+// on errors and by FlushToFile, and rotated into name.1.ext ... name.N.ext
+// once it grows past the rotation size.
 class Logger {
 private:
     struct LogMessage
@@ -58,6 +86,18 @@ public:
     static void SetMinimumLevel(LogLevel level);
     static LogLevel GetMinimumLevel();
     static void FlushToFile();
+    // maxBytes = 0 never rotates, maxFiles is the number of old files kept
+    static void SetRotation(uint64_t maxBytes, int maxFiles);
+    // Formatted lines of the messages logged at or after since
+    static std::vector<std::string> GetLogsSince(std::chrono::system_clock::time_point since);
+
+    static void StartAsync(LogOverflowPolicy policy = LOG_OVERFLOW_BLOCK);
+    // Writes what is still queued, logging is synchronous again afterwards
+    static void StopAsync();
+    static bool IsAsync();
+    // Waits until the writer has handled every message queued before the call
+    static void Flush();
+    static uint64_t GetDroppedLogs();
 
     template <typename... Args>
     static void Log(
@@ -79,7 +119,24 @@ public:
         Args&&... args);
 
 private:
+    static std::ostringstream& FormatBuffer();
+    static void Submit(
+        LogLevel level,
+#ifdef DEBUG
+        const std::string& file,
+        int line,
+#endif
+        int errorCode,
+        std::string_view message);
     static void AddLog(LogMessage&& msg);
+    static void WriterLoop();
+    static size_t DrainQueue();
+    static LogMessage& LogAt(uint64_t sequence);
+    static uint64_t GetOldestLog();
+    static bool OpenLogFile(std::ios::openmode mode);
+    static void BufferToFile(const LogMessage& log);
+    static void WriteFileBuffer();
+    static void RotateFile();
     static size_t CalculateLogLength(const LogMessage& log);
     static size_t CalculateNumberOfLines(const LogMessage& log);
     static std::string FormatTimestamp(const std::chrono::time_point<std::chrono::system_clock>& time);
@@ -91,12 +148,17 @@ private:
     static void ChangeColor(const std::string& color);
     static void ResetColor();
 
-    static std::vector<LogMessage> logs;
+    static std::vector<LogMessage> logs; // Ring of LOGGER_HISTORY_CAPACITY, see LogAt
+    static uint64_t logCount; // Messages kept since the last Clear
     static LogLevel lLevelPrinted;
     static std::mutex logMutex;
     static std::unique_ptr<std::ofstream> logFile;
     static bool isLoggingToFile;
-    static size_t lastFlushedIndex;
+    static std::string logFilename;
+    static std::string fileBuffer;
+    static uint64_t fileBytes; // Size of the current file, buffer included
+    static uint64_t rotateBytes;
+    static int rotateFiles;
 };
 
 
@@ -129,20 +191,16 @@ void Logger::LogError(
     int errorCode, 
     Args&&... args) 
 {    
-    std::ostringstream oss;
+    std::ostringstream& oss = Logger::FormatBuffer();
     ((oss << args), ...);
-    
-    LogMessage msg;
-    msg.level = level;
-    msg.time = std::chrono::system_clock::now();
+    const std::streamoff length = std::max<std::streamoff>(oss.tellp(), 0);
+
+    Logger::Submit(level,
 #ifdef DEBUG
-    msg.file = file;
-    msg.line = line;
+        file, line,
 #endif
-    msg.message = oss.str();
-    msg.errorCode = errorCode;
-    
-    Logger::AddLog(std::move(msg));
+        errorCode, oss.view().substr(0, static_cast<size_t>(length))
+    );
 }
 
 
@@ -0,0 +1,278 @@
+#include "Benchmark.h"
+#include "Camera.h"
+#include "ProfileZones.h"
+
+#include <glad/glad.h>
+
+#include "Logger.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+Benchmark::Benchmark(CameraPath path, const std::string& source, float step, uint64_t seed, const std::vector<int>& lightCounts)
+    : path(std::move(path)), source(source), step(step), seed(seed)
+{
+    this->frameCount = static_cast<uint32_t>(std::floor(this->path.GetDuration() / step)) + 1;
+    this->passes.resize(std::max<size_t>(lightCounts.size(), 1));
+    for (size_t i = 0; i < lightCounts.size(); i++) this->passes[i].lights = lightCounts[i];
+    this->samples.reserve(static_cast<size_t>(this->frameCount) * this->passes.size());
+}
+
+// Total time of a CPU zone in the last collected frame, over every thread
+static std::chrono::nanoseconds GetZoneFrameTime(const char* name) {
+    const ProfileZoneID id = ProfileZones::Find(name);
+    std::chrono::nanoseconds total{0};
+    if (id == PROFILE_ZONE_INVALID_ID) return total;
+    for (size_t thread = 0; thread < ProfileZones::GetThreadCount(); thread++) {
+        for (const ProfileZoneNode& node : ProfileZones::GetFrameTree(thread)) {
+            if (node.id == id) total += node.total;
+        }
+    }
+    return total;
+}
+
+Benchmark::FrameSample* Benchmark::GetSample(uint32_t frame) {
+    const Pass& pass = this->passes[this->pass];
+    if (!pass.started || frame < BENCHMARK_WARMUP_FRAMES || frame - BENCHMARK_WARMUP_FRAMES >= this->frameCount) return nullptr;
+    const size_t index = pass.firstSample + frame - BENCHMARK_WARMUP_FRAMES;
+    return index < this->samples.size() ? &this->samples[index] : nullptr;
+}
+
+bool Benchmark::BeginFrame(Camera& camera, std::chrono::nanoseconds lastFrameTime, const GLFrameCounters& lastCounters) {
+    if (this->done) return false;
+
+    // The frame that just ended, if it was recorded
+    if (FrameSample* sample = this->frame > 0 ? this->GetSample(this->frame - 1) : nullptr) {
+        sample->frameTime = lastFrameTime;
+        sample->lightUploadTime = GetZoneFrameTime(BENCHMARK_UPLOAD_ZONE);
+        sample->drawCalls = lastCounters.drawCalls;
+        sample->drawCommands = lastCounters.drawCommands;
+        sample->triangles = lastCounters.triangles;
+        sample->uploadBytes = lastCounters.uploadBytes;
+        sample->stateBinds = lastCounters.stateBinds;
+    }
+    this->CollectGPUTimes();
+
+    if (this->frame >= BENCHMARK_WARMUP_FRAMES + this->frameCount) {
+        if (this->pass + 1 < this->passes.size()) {
+            // The warmup of the next pass also brings back the last GPU times of this one
+            this->pass++;
+            this->frame = 0;
+        } else {
+            // Path over, wait for the last GPU results
+            const bool complete = std::all_of(this->samples.begin(), this->samples.end(), [](const FrameSample& s) { return s.gpuValid; });
+            if (complete || ++this->drainFrames > GPU_TIMER_LATENCY + 1) {
+                this->done = true;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    if (this->frame == BENCHMARK_WARMUP_FRAMES) {
+        Pass& pass = this->passes[this->pass];
+        pass.gpuFrameBase = GPUTimers::GetFrame();
+        pass.firstSample = this->samples.size();
+        pass.started = true;
+        this->recording = true;
+    }
+    const uint32_t step = this->frame < BENCHMARK_WARMUP_FRAMES ? 0 : this->frame - BENCHMARK_WARMUP_FRAMES;
+    if (this->frame >= BENCHMARK_WARMUP_FRAMES) this->samples.emplace_back();
+
+    glm::vec3 position, orientation;
+    this->path.Sample(step * this->step, position, orientation);
+    camera.SetPosition(position);
+    camera.SetOrientation(orientation);
+    camera.UpdateMatrix();
+
+    this->frame++;
+    return true;
+}
+
+void Benchmark::SetCPUTime(std::chrono::nanoseconds time) {
+    if (this->frame == 0) return;
+    if (FrameSample* sample = this->GetSample(this->frame - 1)) sample->cpuTime = time;
+}
+
+void Benchmark::CollectGPUTimes() {
+    if (!this->recording) return;
+    for (const GPUTimerResult& result : GPUTimers::GetResults()) {
+        // Top level zones make the frame time, nested ones are already inside them
+        const bool cull = GPUTimers::GetName(result.name) == BENCHMARK_CULL_ZONE;
+        if (result.depth != 0 && !cull) continue;
+        for (const Pass& pass : this->passes) {
+            if (!pass.started || result.frame < pass.gpuFrameBase || result.frame - pass.gpuFrameBase >= this->frameCount) continue;
+            const size_t index = pass.firstSample + (result.frame - pass.gpuFrameBase);
+            if (index >= this->samples.size()) break;
+            if (cull) this->samples[index].cullTime += result.end - result.start;
+            if (result.depth == 0) {
+                this->samples[index].gpuTime += result.end - result.start;
+                this->samples[index].gpuValid = true;
+            }
+            break;
+        }
+    }
+}
+
+namespace
+{
+    struct Summary
+    {
+        double average = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // Nearest rank percentiles
+    Summary Summarize(std::vector<double> values) {
+        Summary summary;
+        if (values.empty()) return summary;
+        std::sort(values.begin(), values.end());
+        auto rank = [&](double p) {
+            const size_t index = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+            return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+        };
+        for (double value : values) summary.average += value;
+        summary.average /= values.size();
+        summary.p50 = rank(50.0);
+        summary.p95 = rank(95.0);
+        summary.p99 = rank(99.0);
+        summary.max = values.back();
+        return summary;
+    }
+
+    void WriteSummary(std::ofstream& file, const char* name, const Summary& summary, const char* indent = "    ") {
+        file << indent << "\"" << name << "\": {\"avg\":" << summary.average << ",\"p50\":" << summary.p50 << ",\"p95\":" << summary.p95
+             << ",\"p99\":" << summary.p99 << ",\"max\":" << summary.max << "}";
+    }
+
+    std::string GetGLString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        if (value == nullptr) return "";
+        std::string result;
+        for (const char* c = reinterpret_cast<const char*>(value); *c != '\0'; c++) {
+            if (*c == '"' || *c == '\\') result += '\\';
+            result += *c;
+        }
+        return result;
+    }
+}
+
+std::string Benchmark::WriteReport(const std::string& output) const {
+    std::string filename = output;
+    if (filename.empty()) {
+        auto now = std::chrono::system_clock::now();
+        auto time_t = std::chrono::system_clock::to_time_t(now);
+        std::stringstream ss;
+        ss << GetUserDataPath() << "benchmarks/benchmark_" << std::put_time(std::localtime(&time_t), "%Y-%m-%d_%H-%M-%S") << ".json";
+        filename = ss.str();
+    }
+    if (std::filesystem::path(filename).has_parent_path()) {
+        std::filesystem::create_directories(std::filesystem::path(filename).parent_path());
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to open benchmark report: ", filename);
+        return "";
+    }
+
+    std::vector<double> frameTimes, cpuTimes, gpuTimes, drawCalls, triangles;
+    for (const FrameSample& sample : this->samples) {
+        frameTimes.push_back(sample.frameTime.count() * 1e-6);
+        cpuTimes.push_back(sample.cpuTime.count() * 1e-6);
+        if (sample.gpuValid) gpuTimes.push_back(sample.gpuTime.count() * 1e-6);
+        drawCalls.push_back(sample.drawCalls);
+        triangles.push_back(static_cast<double>(sample.triangles));
+    }
+    const Summary frameSummary = Summarize(frameTimes);
+
+    std::string source;
+    for (char c : this->source) {
+        if (c == '"' || c == '\\') source += '\\';
+        source += c;
+    }
+
+    file << "{\n  \"path\": \"" << source << "\",\n  \"seed\": " << this->seed << ",\n  \"stepSeconds\": " << this->step
+         << ",\n  \"warmupFrames\": " << BENCHMARK_WARMUP_FRAMES << ",\n  \"frames\": " << this->samples.size()
+         << ",\n  \"gpuFrames\": " << gpuTimes.size()
+         << ",\n  \"renderer\": \"" << GetGLString(GL_RENDERER) << "\",\n  \"version\": \"" << GetGLString(GL_VERSION) << "\""
+         << ",\n  \"summary\": {\n";
+    WriteSummary(file, "frameMs", frameSummary);
+    file << ",\n";
+    WriteSummary(file, "cpuMs", Summarize(cpuTimes));
+    file << ",\n";
+    WriteSummary(file, "gpuMs", Summarize(gpuTimes));
+    file << ",\n";
+    WriteSummary(file, "drawCalls", Summarize(drawCalls));
+    file << ",\n";
+    WriteSummary(file, "triangles", Summarize(triangles));
+    // One pass per light count, the light culling cost is what changes between them
+    file << "\n  },\n  \"passes\": [";
+    std::vector<Summary> passFrames;
+    std::vector<Summary> passCulling;
+    for (size_t p = 0; p < this->passes.size(); p++) {
+        const Pass& pass = this->passes[p];
+        const size_t end = p + 1 < this->passes.size() && this->passes[p + 1].started ? this->passes[p + 1].firstSample : this->samples.size();
+        std::vector<double> passFrameTimes, passCPUTimes, passGPUTimes, cullTimes, uploadTimes;
+        for (size_t i = pass.started ? pass.firstSample : end; i < end; i++) {
+            const FrameSample& sample = this->samples[i];
+            passFrameTimes.push_back(sample.frameTime.count() * 1e-6);
+            passCPUTimes.push_back(sample.cpuTime.count() * 1e-6);
+            uploadTimes.push_back(sample.lightUploadTime.count() * 1e-6);
+            if (!sample.gpuValid) continue;
+            passGPUTimes.push_back(sample.gpuTime.count() * 1e-6);
+            cullTimes.push_back(sample.cullTime.count() * 1e-6);
+        }
+        passFrames.push_back(Summarize(passFrameTimes));
+        passCulling.push_back(Summarize(cullTimes));
+
+        file << (p == 0 ? "" : ",") << "\n    {\n      \"lights\": " << pass.lights << ",\n      \"frames\": " << passFrameTimes.size()
+             << ",\n      \"gpuFrames\": " << passGPUTimes.size() << ",\n";
+        WriteSummary(file, "frameMs", passFrames.back(), "      ");
+        file << ",\n";
+        WriteSummary(file, "cpuMs", Summarize(passCPUTimes), "      ");
+        file << ",\n";
+        WriteSummary(file, "gpuMs", Summarize(passGPUTimes), "      ");
+        file << ",\n";
+        WriteSummary(file, "cullGpuMs", passCulling.back(), "      ");
+        file << ",\n";
+        WriteSummary(file, "lightUploadMs", Summarize(uploadTimes), "      ");
+        file << "\n    }";
+    }
+    file << "\n  ],\n  \"perFrame\": [";
+    size_t samplePass = 0;
+    for (size_t i = 0; i < this->samples.size(); i++) {
+        const FrameSample& sample = this->samples[i];
+        while (samplePass + 1 < this->passes.size() && this->passes[samplePass + 1].started && i >= this->passes[samplePass + 1].firstSample) samplePass++;
+        file << (i == 0 ? "" : ",") << "\n    {\"lights\":" << this->passes[samplePass].lights
+             << ",\"frameMs\":" << sample.frameTime.count() * 1e-6 << ",\"cpuMs\":" << sample.cpuTime.count() * 1e-6
+             << ",\"lightUploadMs\":" << sample.lightUploadTime.count() * 1e-6 << ",\"gpuMs\":";
+        if (sample.gpuValid) file << sample.gpuTime.count() * 1e-6;
+        else file << "null";
+        file << ",\"cullGpuMs\":";
+        if (sample.gpuValid) file << sample.cullTime.count() * 1e-6;
+        else file << "null";
+        file << ",\"drawCalls\":" << sample.drawCalls << ",\"drawCommands\":" << sample.drawCommands << ",\"triangles\":" << sample.triangles
+             << ",\"uploadBytes\":" << sample.uploadBytes << ",\"stateBinds\":" << sample.stateBinds << "}";
+    }
+    file << "\n  ]\n}\n";
+    file.close();
+
+    if (this->passes.size() > 1) {
+        for (size_t p = 0; p < this->passes.size(); p++) {
+            LOG_INFO("Benchmark: ", this->passes[p].lights, " lights, frame p50/p95 ", passFrames[p].p50, "/", passFrames[p].p95,
+                "ms, light culling avg ", passCulling[p].average, "ms");
+        }
+    }
+    LOG_INFO("Benchmark: ", this->samples.size(), " frames, frame p50/p95/p99 ", frameSummary.p50, "/", frameSummary.p95, "/",
+        frameSummary.p99, "ms, report written to ", filename);
+    return filename;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "CameraPath.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+bool CameraPath::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to open camera path: ", path);
+        return false;
+    }
+
+    this->keyframes.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::istringstream ss(line);
+        CameraKeyframe keyframe;
+        if (!(ss >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+                 >> keyframe.orientation.x >> keyframe.orientation.y >> keyframe.orientation.z)) {
+            LOG_ERROR(1, "Invalid camera keyframe at ", path, ":", lineNumber);
+            return false;
+        }
+        if (!this->keyframes.empty() && keyframe.time < this->keyframes.back().time) {
+            LOG_ERROR(1, "Camera keyframes out of order at ", path, ":", lineNumber);
+            return false;
+        }
+        this->keyframes.push_back(keyframe);
+    }
+
+    if (this->keyframes.empty()) {
+        LOG_ERROR(1, "Camera path has no keyframe: ", path);
+        return false;
+    }
+    return true;
+}
+
+bool CameraPath::Save(const std::string& path) const {
+    if (std::filesystem::path(path).has_parent_path()) {
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    }
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to write camera path: ", path);
+        return false;
+    }
+
+    file << "# time px py pz ox oy oz\n";
+    for (const CameraKeyframe& keyframe : this->keyframes) {
+        file << keyframe.time << " " << keyframe.position.x << " " << keyframe.position.y << " " << keyframe.position.z << " "
+             << keyframe.orientation.x << " " << keyframe.orientation.y << " " << keyframe.orientation.z << "\n";
+    }
+    return true;
+}
+
+CameraPath CameraPath::Orbit(float radius, float height, float duration) {
+    CameraPath path;
+    for (int i = 0; i <= CAMERA_PATH_ORBIT_KEYFRAMES; i++) {
+        const float t = static_cast<float>(i) / CAMERA_PATH_ORBIT_KEYFRAMES;
+        const float angle = glm::radians(360.0f * t);
+        const glm::vec3 position(radius * std::cos(angle), height, radius * std::sin(angle));
+        path.AddKeyframe(t * duration, position, glm::normalize(-position));
+    }
+    return path;
+}
+
+void CameraPath::AddKeyframe(float time, glm::vec3 position, glm::vec3 orientation) {
+    this->keyframes.push_back({ time, position, orientation });
+}
+
+void CameraPath::Sample(float time, glm::vec3& position, glm::vec3& orientation) const {
+    if (this->keyframes.empty()) return;
+
+    auto next = std::upper_bound(this->keyframes.begin(), this->keyframes.end(), time,
+        [](float t, const CameraKeyframe& keyframe) { return t < keyframe.time; });
+    if (next == this->keyframes.begin() || next == this->keyframes.end()) {
+        const CameraKeyframe& keyframe = next == this->keyframes.begin() ? this->keyframes.front() : this->keyframes.back();
+        position = keyframe.position;
+        orientation = keyframe.orientation;
+        return;
+    }
+
+    const CameraKeyframe& a = *(next - 1);
+    const CameraKeyframe& b = *next;
+    const float t = b.time > a.time ? (time - a.time) / (b.time - a.time) : 1.0f;
+    position = glm::mix(a.position, b.position, t);
+    // Opposite orientations have no midpoint, snap to the next one
+    const glm::vec3 mixed = glm::mix(a.orientation, b.orientation, t);
+    orientation = glm::length(mixed) > 1e-4f ? glm::normalize(mixed) : b.orientation;
+}
\ No newline at end of file
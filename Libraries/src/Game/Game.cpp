@@ -8,7 +8,8 @@ Game::~Game() {
     this->stop();
 }
 
-void Game::init() {
+void Game::init(const GameOptions& options) {
+    this->options = options;
     int *w = window.GetWidthptr();
 	int *h = window.GetHeightptr();
 
@@ -17,25 +18,69 @@ void Game::init() {
     this->camera.SetNearPlane(0.1f);
     this->camera.SetFarPlane(1000.0f);
 
+    if (!options.benchmarkPath.empty()) {
+        CameraPath path;
+        if (options.benchmarkPath == "orbit") {
+            path = CameraPath::Orbit(BENCHMARK_ORBIT_RADIUS, BENCHMARK_ORBIT_HEIGHT);
+        } else if (!path.Load(options.benchmarkPath)) {
+            this->benchmarkFailed = true;
+        }
+        if (!this->benchmarkFailed) {
+            const uint64_t seed = options.seed >= 0 ? options.seed : BENCHMARK_DEFAULT_SEED;
+            this->benchmark = std::make_unique<Benchmark>(std::move(path), options.benchmarkPath, options.benchmarkStep, seed, options.lightStress);
+            this->options.seed = seed;
+            // Frames run back to back, the path advances by a fixed step each
+            this->window.SetMaxFPS(0);
+            LOG_INFO("Benchmark: ", this->benchmark->GetFrameCount(), " frames of ", options.benchmarkPath, ", seed ", seed);
+        } else {
+            glfwSetWindowShouldClose(this->window.GetWindow(), GLFW_TRUE);
+        }
+    }
+
     this->world = std::make_unique<World>();
+    if (this->options.seed >= 0) this->world->SetTerrainSeed(this->options.seed);
     this->world->Init();
+    // A benchmark sets the lights of each of its passes
+    if (!this->benchmark && !options.lightStress.empty()) {
+        if (options.lightStress.size() > 1) LOG_WARNING("Light counts are only swept by --benchmark, using ", options.lightStress.front());
+        this->world->SetStressLights(options.lightStress.front());
+    }
 
     this->textRenderer = std::make_unique<UI::TextRenderer>();
     textRenderer->init(*window.GetWidthptr(), *window.GetHeightptr());
     textRenderer->loadFont(GET_RESOURCE_PATH("fonts/Roboto-Regular.ttf"), "default", 48);
+
+    HitchDetector::SetThreshold(options.hitchThreshold);
+    GLCounters::EnablePipelineStatistics(options.pipelineStats);
+    if (options.allocReportFrames > 0 || options.allocBudget >= 0) {
+        AllocationTracker::StartReport(options.allocReportFrames > 0 ? options.allocReportFrames : ALLOC_REPORT_DEFAULT_FRAMES,
+            options.allocBudget);
+    }
+    if (options.traceFrames > 0) {
+        TraceCapture::Start(options.traceFrames);
+    }
 }
 
 void Game::stop() {
+    if (!this->options.recordPath.empty() && !this->recordedPath.IsEmpty()) {
+        if (this->recordedPath.Save(this->options.recordPath)) LOG_INFO("Camera path written to ", this->options.recordPath);
+        this->recordedPath.Clear();
+    }
     glfwMakeContextCurrent(this->window.GetWindow());
+    TraceCapture::Stop();
     this->world->Destroy();
     this->world.reset();
     this->camera.Destroy();
+    StreamBuffer::DestroyFences();
+    GPUTimers::Destroy();
+    GLCounters::Destroy();
     this->window.Close();
 }
 
 void Game::run() {
     glGetError();
     while (!window.ShouldClose()) {
+        PROFILE_SCOPE("Frame");
 
         if (this->window.NewFrame()) {
             // std::string title = "fps: " + std::to_string(window.GetFPS()) +
@@ -47,25 +92,73 @@ void Game::run() {
             // glfwSetWindowTitle(window.GetWindow(), title.c_str());
         }
 
+        // Counters still hold the previous frame, the one the window just timed
+        GLCounters::BeginFrame();
+        AllocationTracker::BeginFrame();
+        const GLStateStats& glStats = GLState::GetFrameStats();
+        const GLFrameCounters& glCounters = GLCounters::GetLastFrame();
+        const AllocationCounters& allocations = AllocationTracker::GetLastFrame();
+        const RenderQueueStats& renderStats = this->world->GetRenderStats();
+        HitchDetector::NewFrame(this->window.GetElapseTime(),
+            { glStats.issued, glStats.skipped, renderStats.drawCalls, renderStats.GetStateChanges(),
+              glCounters.triangles, glCounters.uploadBytes, glCounters.programSwitches, glCounters.textureBinds,
+              allocations.allocations, allocations.bytes });
+
+        // A budget run ends with its report, main turns the result into the exit code
+        if (this->options.allocBudget >= 0 && AllocationTracker::IsReportDone()) {
+            glfwSetWindowShouldClose(this->window.GetWindow(), GLFW_TRUE);
+        }
+        if (this->benchmark && !this->benchmark->IsDone()
+            && !this->benchmark->BeginFrame(this->camera, this->window.GetElapseTime(), glCounters)) {
+            if (this->benchmark->WriteReport(this->options.benchmarkOutput).empty()) this->benchmarkFailed = true;
+            glfwSetWindowShouldClose(this->window.GetWindow(), GLFW_TRUE);
+        }
+        // A new pass starts with its warmup, changing the lights there is not recorded
+        if (this->benchmark && !this->benchmark->IsDone() && this->benchmark->GetLightCount() != this->world->GetStressLights()) {
+            this->world->SetStressLights(this->benchmark->GetLightCount());
+        }
+        const int64_t cpuStart = ProfileZones::Now();
+
+        GLState::BeginFrame();
+        StreamBuffer::BeginFrame();
         Profiler::ProfileGPU("Render", &Game::render, this);
         this->update();
+        StreamBuffer::EndFrame();
+        if (this->benchmark) this->benchmark->SetCPUTime(std::chrono::nanoseconds(ProfileZones::Now() - cpuStart));
 
         Profiler::ProfileGPU("SwapBuffers", &Window::SwapBuffers, window);
     }
 }
 
+int Game::GetExitCode() const {
+    if (this->benchmarkFailed || AllocationTracker::IsOverBudget()) return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
+
 void Game::processInput() {
 
 }
 
 void Game::update() {
-    this->camera.Inputs(this->window.GetWindow(), 1.0 / this->window.GetFPS());
-    this->camera.UpdateMatrix();
+    PROFILE_SCOPE("Update");
+    // A benchmark moves the camera itself, in Benchmark::BeginFrame
+    if (!this->benchmark) {
+        this->camera.Inputs(this->window.GetWindow(), 1.0 / this->window.GetFPS());
+        this->camera.UpdateMatrix();
+    }
+
+    if (!this->options.recordPath.empty()) {
+        this->recordTime += static_cast<float>(this->window.GetElapseTimeSecond());
+        if (this->recordedPath.IsEmpty() || this->recordTime - this->recordedPath.GetDuration() >= CAMERA_PATH_RECORD_INTERVAL) {
+            this->recordedPath.AddKeyframe(this->recordTime, this->camera.GetPosition(), this->camera.GetOrientation());
+        }
+    }
 
     this->world->Update();
 }
 
 void Game::render() {
+    PROFILE_SCOPE("Render");
     Profiler::ProfileGPU("Clear", &Window::Clear, window);
     this->camera.BindUBO();
     Profiler::ProfileGPU("RenderWorld", &World::Render, this->world.get(), this->camera);
@@ -81,4 +174,38 @@ void Game::render() {
         glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
     textRenderer->renderText(std::format("Swap Buffers: {:.3f}ms", Profiler::GetAverageTime("SwapBuffers").count() * 1e-6), 10, 110, 0.3f,
         glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    const RenderQueueStats& renderStats = this->world->GetRenderStats();
+    textRenderer->renderText(std::format("Draw calls: {}, State changes: {}", renderStats.drawCalls, renderStats.GetStateChanges()), 10, 130, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    const GLStateStats& glStats = GLState::GetFrameStats();
+    textRenderer->renderText(std::format("GL binds: {} issued, {} skipped", glStats.issued, glStats.skipped), 10, 150, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    textRenderer->renderText(std::format("Lights: {}/{}, culling: {:.3f}ms", this->world->GetVisibleLightCount(), this->world->GetLightCount(), Profiler::GetAverageTime("LightCulling").count() * 1e-6), 10, 170, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    textRenderer->renderText(std::format("CPU update: {:.3f}ms, light upload: {:.3f}ms, flush: {:.3f}ms",
+        ProfileZones::GetAverageTotalTime("Update").count() * 1e-6,
+        ProfileZones::GetAverageTotalTime("LightUpload").count() * 1e-6,
+        ProfileZones::GetAverageTotalTime("QueueFlush").count() * 1e-6), 10, 190, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    textRenderer->renderText(std::format("Frame p50/p95/p99/p99.9: {:.2f}/{:.2f}/{:.2f}/{:.2f}ms",
+        window.GetFrameTimePercentileMillisecond(50.0), window.GetFrameTimePercentileMillisecond(95.0),
+        window.GetFrameTimePercentileMillisecond(99.0), window.GetFrameTimePercentileMillisecond(99.9)), 10, 210, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    const GLFrameCounters& glCounters = GLCounters::GetLastFrame();
+    textRenderer->renderText(std::format("GL draws: {} ({} cmds), {} tris, upload: {:.1f}KB, programs: {}, textures: {}, dispatches: {}",
+        glCounters.drawCalls, glCounters.drawCommands, glCounters.triangles, glCounters.uploadBytes / 1024.0,
+        glCounters.programSwitches, glCounters.textureBinds, glCounters.dispatches), 10, 230, 0.3f,
+        glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    if (AllocationTracker::IsEnabled()) {
+        const AllocationCounters& allocations = AllocationTracker::GetLastFrame();
+        textRenderer->renderText(std::format("Allocations: {} ({:.1f}KB), frees: {}",
+            allocations.allocations, allocations.bytes / 1024.0, allocations.frees), 10, 250, 0.3f,
+            glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    }
+    if (glCounters.pipelineValid) {
+        textRenderer->renderText(std::format("Pipeline: {} prims, {} clipped, {} VS, {} FS",
+            glCounters.primitivesSubmitted, glCounters.clippedPrimitives,
+            glCounters.vertexInvocations, glCounters.fragmentInvocations), 10, 270, 0.3f,
+            glm::vec3(1.0f, 0.8f, 1.0f), UI::TextAnchor::TopLeft);
+    }
 }
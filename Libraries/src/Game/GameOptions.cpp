@@ -0,0 +1,84 @@
+#include "GameOptions.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void PrintUsage() {
+    std::cout <<
+        "Usage: ProceduralGeneration [options]\n"
+        "  --light-stress <int[,int...]>  spawn 1-" << LIGHT_STRESS_MAX << " point lights over the terrain, a benchmark replays its path for each count\n"
+        "  --trace-frames <int>  write a Chrome trace of the first 1-" << TRACE_FRAMES_MAX << " frames (F9 toggles one)\n"
+        "  --hitch-threshold <float>  snapshot frames slower than this many median frames, 0 = off (default " << HITCH_DEFAULT_THRESHOLD << ")\n"
+        "  --pipeline-stats  query primitive and shader invocation counts every frame\n"
+        "  --alloc-report <int>  report the allocations of 1-" << ALLOC_REPORT_FRAMES_MAX << " steady state frames (needs make TRACK_ALLOCATIONS=1)\n"
+        "  --alloc-budget <int>  fail when a steady state frame allocates more than this, then exit\n"
+        "  --benchmark <file|orbit>  replay a camera path with a fixed timestep and no frame limiter, write a JSON report, then exit\n"
+        "  --benchmark-out <file>  benchmark report file (default under the user data path)\n"
+        "  --benchmark-step <float>  seconds of camera path per frame (default " << BENCHMARK_DEFAULT_STEP << ")\n"
+        "  --seed <int>  terrain seed (default random, " << BENCHMARK_DEFAULT_SEED << " in a benchmark)\n"
+        "  --record-path <file>  record the camera into a path file usable by --benchmark\n"
+        "  --sync-log  print log messages from the thread logging them instead of a writer thread\n"
+        "  --log-overflow <block|drop|sample>  what logging does when the writer thread is behind (default block)\n";
+}
+
+// Options followed by a value, matched before the value is read
+static const char* const VALUE_OPTIONS[] = {
+    "--light-stress", "--trace-frames", "--hitch-threshold", "--alloc-report", "--alloc-budget", "--benchmark",
+    "--benchmark-out", "--benchmark-step", "--seed", "--record-path", "--log-overflow"
+};
+
+bool ParseGameOptions(int argc, char** argv, GameOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                LOG_ERROR(1, "Missing value for ", arg);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* value = nullptr;
+        if (arg == "--help" || arg == "-h") { PrintUsage(); std::exit(EXIT_SUCCESS); }
+        if (arg == "--pipeline-stats") { options.pipelineStats = true; continue; }
+        if (arg == "--sync-log") { options.asyncLog = false; continue; }
+
+        if (std::find(std::begin(VALUE_OPTIONS), std::end(VALUE_OPTIONS), arg) == std::end(VALUE_OPTIONS)) {
+            LOG_ERROR(1, "Unknown option ", arg);
+            PrintUsage();
+            return false;
+        }
+        if (!(value = next())) return false;
+        if (arg == "--light-stress") {
+            options.lightStress.clear();
+            for (const char* count = value; count != nullptr; count = std::strchr(count, ',')) {
+                if (*count == ',') count++;
+                options.lightStress.push_back(std::clamp(std::atoi(count), 1, LIGHT_STRESS_MAX));
+            }
+        }
+        else if (arg == "--trace-frames") options.traceFrames = std::clamp(std::atoi(value), 1, TRACE_FRAMES_MAX);
+        else if (arg == "--hitch-threshold") options.hitchThreshold = std::max(static_cast<float>(std::atof(value)), 0.0f);
+        else if (arg == "--alloc-report") options.allocReportFrames = std::clamp(std::atoi(value), 1, ALLOC_REPORT_FRAMES_MAX);
+        else if (arg == "--alloc-budget") options.allocBudget = std::max<int64_t>(std::atoll(value), 0);
+        else if (arg == "--benchmark") options.benchmarkPath = value;
+        else if (arg == "--benchmark-out") options.benchmarkOutput = value;
+        else if (arg == "--benchmark-step") options.benchmarkStep = std::clamp(static_cast<float>(std::atof(value)), 1e-4f, 1.0f);
+        else if (arg == "--seed") options.seed = std::max<int64_t>(std::atoll(value), 0);
+        else if (arg == "--record-path") options.recordPath = value;
+        else if (arg == "--log-overflow") {
+            const std::string policy = value;
+            if (policy == "block") options.logOverflow = LOG_OVERFLOW_BLOCK;
+            else if (policy == "drop") options.logOverflow = LOG_OVERFLOW_DROP;
+            else if (policy == "sample") options.logOverflow = LOG_OVERFLOW_SAMPLE;
+            else {
+                LOG_ERROR(1, "Unknown log overflow policy ", policy);
+                return false;
+            }
+        }
+    }
+    return true;
+}
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "World.h"
+#include "ObjectTransforms.h"
+#include "Profiler.h"
+#include "Random.h"
 
 World::World()
 {
@@ -22,6 +25,7 @@ void World::Init()
     
 
     this->lightManager.updateSSBO();
+    this->clusteredLighting.Initialize();
     
 
     this->terrain.init(500.0f, 500.0f, 500, 500);
@@ -31,10 +35,41 @@ void World::Init()
 
 }
 
+void World::SetStressLights(int count)
+{
+    // The stress lights are the last ones, removing the last light only pops it
+    for (; this->stressLights > 0; this->stressLights--) {
+        this->lightManager.RemoveLight(this->lightManager.GetLightCount() - 1);
+    }
+    if (count <= 0) return;
+
+    const Grid& grid = this->terrain.GetGrid();
+    const Heightfield& heightfield = grid.GetHeightfield();
+    const float halfX = grid.GetSizeX() / 2.0f;
+    const float halfZ = grid.GetSizeZ() / 2.0f;
+
+    PCGRandom random(1234);
+    std::vector<lght::Light> lights;
+    lights.reserve(count);
+    for (int i = 0; i < count; i++) {
+        float x = random.nextFloat(-halfX, halfX);
+        float z = random.nextFloat(-halfZ, halfZ);
+        glm::vec3 color(random.nextFloat(0.3f, 1.0f), random.nextFloat(0.3f, 1.0f), random.nextFloat(0.3f, 1.0f));
+        // Roughly 30 units of range, see lightRange in light_cull.comp
+        lights.push_back(lght::PointLight(glm::vec3(x, heightfield.HeightAt(x, z) + 3.0f, z), color, 2.0f, 0.2f, 0.05f));
+    }
+    this->lightManager.AddLight(lights);
+    this->stressLights = count;
+    LOG_INFO("Light stress scene: ", count, " point lights");
+}
+
 void World::Destroy()
 {
     this->terrain.Destroy();
     this->lightManager.Destroy();
+    this->renderQueue.Destroy();
+    this->clusteredLighting.Destroy();
+    ObjectTransforms::Destroy();
 }
 
 
@@ -46,6 +81,9 @@ void World::Update()
 
 void World::Render(Camera& camera)
 {
+    this->lightManager.updateSSBO(camera.GetFrustum());
     this->lightManager.BindSSBO();
-    this->terrain.Render(camera);
+    Profiler::ProfileGPU("LightCulling", &ClusteredLighting::Cull, &this->clusteredLighting, camera);
+    this->terrain.Submit(this->renderQueue, camera);
+    this->renderQueue.Flush(camera.IsWireframe());
 }
\ No newline at end of file
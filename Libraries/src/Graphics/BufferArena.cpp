@@ -0,0 +1,93 @@
+#include "BufferArena.h"
+#include "GLBuffer.h"
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+BufferArena::~BufferArena() {
+    this->Destroy();
+}
+
+bool BufferArena::Initialize(size_t capacity, size_t alignment, GLenum usage) {
+    this->Destroy();
+    this->alignment = std::max<size_t>(alignment, 1);
+    this->usage = usage;
+    this->Reserve(capacity);
+    return this->ID != 0;
+}
+
+void BufferArena::Destroy() {
+    if (this->ID != 0) GLState::DeleteBuffers(1, &this->ID);
+    this->ID = 0;
+    this->capacity = 0;
+    this->end = 0;
+    this->used = 0;
+    this->freeRanges.clear();
+}
+
+void BufferArena::Reserve(size_t newCapacity) {
+    if (newCapacity <= this->capacity && this->ID != 0) return;
+    // Only the bytes up to the end can hold data
+    if (!GLBuffer::Reallocate(this->ID, this->end, newCapacity, this->usage)) return;
+    this->capacity = newCapacity;
+}
+
+bool BufferArena::Allocate(size_t size, BufferRange& range) {
+    if (size == 0) return false;
+    size = (size + this->alignment - 1) / this->alignment * this->alignment;
+
+    auto it = std::find_if(this->freeRanges.begin(), this->freeRanges.end(),
+        [size](const BufferRange& free) { return free.size >= size; });
+    if (it != this->freeRanges.end()) {
+        range = { it->offset, size };
+        it->offset += size;
+        it->size -= size;
+        if (it->size == 0) this->freeRanges.erase(it);
+    } else {
+        if (this->end + size > this->capacity) {
+            this->Reserve(GLBuffer::GrowCapacity(this->capacity, this->end + size));
+            if (this->end + size > this->capacity) return false;
+        }
+        range = { this->end, size };
+        this->end += size;
+    }
+    this->used += size;
+    return true;
+}
+
+void BufferArena::Free(BufferRange& range) {
+    if (!range.IsValid() || range.size == 0) return;
+    this->used -= range.size;
+
+    auto it = std::lower_bound(this->freeRanges.begin(), this->freeRanges.end(), range,
+        [](const BufferRange& a, const BufferRange& b) { return a.offset < b.offset; });
+    it = this->freeRanges.insert(it, range);
+    range = BufferRange();
+
+    // Merge with the neighbours
+    if (it + 1 != this->freeRanges.end() && it->offset + it->size == (it + 1)->offset) {
+        it->size += (it + 1)->size;
+        this->freeRanges.erase(it + 1);
+    }
+    if (it != this->freeRanges.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+        (it - 1)->size += it->size;
+        it = this->freeRanges.erase(it) - 1;
+    }
+
+    if (it->offset + it->size == this->end) {
+        this->end = it->offset;
+        this->freeRanges.erase(it);
+    }
+}
+
+void BufferArena::Upload(const BufferRange& range, const void* data, size_t size, size_t offset) const {
+    if (this->ID == 0 || !range.IsValid() || offset + size > range.size) return;
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, this->ID);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, range.offset + offset, size, data);
+    GLCounters::CountUpload(size);
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GL_CHECK_ERROR_M("Buffer arena upload");
+}
\ No newline at end of file
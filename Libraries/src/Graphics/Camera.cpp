@@ -182,17 +182,19 @@ void Camera::Inputs(GLFWwindow* window, float ElapseTime) {
 }
 
 void Camera::InitializeUBO() {
-    this->bUBO.initialize(sizeof(CameraUBO), CAMERA_BINDING_POINT, GL_DYNAMIC_DRAW);
+    // Room for a few updates per frame with offsets aligned up to 256 bytes, it grows if needed
+    this->bUBO.Initialize(GL_UNIFORM_BUFFER, 4 * 256);
     this->UpdateUBO();
 }
 
 void Camera::UpdateUBO() {
     CameraUBO data = { this->position, 0, this->camMatrix };
-    this->bUBO.uploadData(&data, sizeof(CameraUBO));
+    size_t offset = this->bUBO.Write(&data, sizeof(CameraUBO));
+    this->bUBO.BindRange(CAMERA_BINDING_POINT, offset, sizeof(CameraUBO));
 }
 
-void Camera::BindUBO() const {
-    this->bUBO.BindToBindingPoint();
+void Camera::BindUBO() {
+    this->UpdateUBO();
 }
 
 
@@ -0,0 +1,41 @@
+#include "ClusteredLighting.h"
+
+#include "utilities.h"
+
+ClusteredLighting::~ClusteredLighting() {
+    this->Destroy();
+}
+
+bool ClusteredLighting::Initialize() {
+    if (!this->cullShader.SetShader(GET_RESOURCE_PATH("shader/light_cull.comp"))) return false;
+    this->clusterBlock.Initialize(GL_UNIFORM_BUFFER, sizeof(ClusterBlock));
+    this->lightGrid.Initialize(CLUSTER_COUNT * sizeof(GLuint), LIGHT_GRID_BINDING_POINT);
+    this->lightIndices.Initialize(CLUSTER_COUNT * CLUSTER_MAX_LIGHTS * sizeof(GLuint), LIGHT_INDEX_BINDING_POINT);
+    return true;
+}
+
+void ClusteredLighting::Destroy() {
+    this->cullShader.Destroy();
+    this->clusterBlock.Destroy();
+    this->lightGrid.Destroy();
+    this->lightIndices.Destroy();
+}
+
+void ClusteredLighting::Cull(const Camera& camera) {
+    if (!this->cullShader.IsCompiled()) return;
+
+    ClusterBlock block = {
+        camera.GetViewMatrix(),
+        glm::inverse(camera.GetProjectionMatrix()),
+        glm::vec4(camera.GetNearPlane(), camera.GetFarPlane(), 0.0f, 0.0f)
+    };
+    size_t offset = this->clusterBlock.Write(&block, sizeof(ClusterBlock));
+    this->clusterBlock.BindRange(CLUSTER_BINDING_POINT, offset, sizeof(ClusterBlock));
+    this->lightGrid.BindToPoint();
+    this->lightIndices.BindToPoint();
+
+    // One work group per depth slice, one invocation per cluster of the slice
+    this->cullShader.Dispatch(1, 1, CLUSTER_GRID_Z);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    GL_CHECK_ERROR_M("Light culling");
+}
\ No newline at end of file
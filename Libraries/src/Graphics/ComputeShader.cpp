@@ -0,0 +1,93 @@
+#include "ComputeShader.h"
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include <cstring>
+
+ComputeShader::ComputeShader(const char* computePath) {
+    this->SetShader(computePath);
+}
+
+ComputeShader::~ComputeShader() {
+    this->Destroy();
+}
+
+ComputeShader::ComputeShader(ComputeShader&& other) noexcept {
+    std::swap(this->ID, other.ID);
+}
+
+ComputeShader& ComputeShader::operator=(ComputeShader&& other) noexcept {
+    if (this != &other) {
+        this->Destroy();
+        std::swap(this->ID, other.ID);
+    }
+    return *this;
+}
+
+bool ComputeShader::SetShader(const char* computePath) {
+    std::string source;
+    try {
+        source = get_file_contents(computePath);
+    } catch (int e) {
+        LOG_ERROR(1, "Failed to load compute shader from ", computePath, ": ", strerror(e));
+        this->Destroy();
+        return false;
+    }
+    return this->SetShaderCode(source);
+}
+
+bool ComputeShader::SetShaderCode(const std::string& computeCode) {
+    this->Destroy();
+
+    const char* source = computeCode.c_str();
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint status;
+    char infoLog[1024];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status == GL_FALSE) {
+        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        LOG_ERROR(1, "SHADER_COMPILATION_ERROR for: COMPUTE\n", infoLog);
+        glDeleteShader(shader);
+        return false;
+    }
+
+    this->ID = glCreateProgram();
+    glAttachShader(this->ID, shader);
+    glLinkProgram(this->ID);
+    glDeleteShader(shader);
+
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        glGetProgramInfoLog(this->ID, 1024, NULL, infoLog);
+        LOG_ERROR(1, "SHADER_LINKING_ERROR for: COMPUTE\n", infoLog);
+        this->Destroy();
+        return false;
+    }
+    return true;
+}
+
+void ComputeShader::Bind() const {
+    if (this->ID == 0) return;
+    GLState::UseProgram(this->ID);
+}
+
+void ComputeShader::Unbind() const {
+    GLState::UseProgram(0);
+}
+
+void ComputeShader::Dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ) const {
+    if (this->ID == 0) return;
+    this->Bind();
+    glDispatchCompute(groupsX, groupsY, groupsZ);
+    GLCounters::CountDispatch();
+    GL_CHECK_ERROR_M("Compute dispatch");
+}
+
+void ComputeShader::Destroy() {
+    if (this->ID == 0) return;
+    GLState::DeleteProgram(this->ID);
+    this->ID = 0;
+}
\ No newline at end of file
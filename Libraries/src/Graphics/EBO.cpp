@@ -1,4 +1,6 @@
 #include "EBO.h"
+#include "GLCounters.h"
+#include "GLState.h"
 
 #include "Logger.h"
 
@@ -25,7 +27,7 @@ void EBO::Swap(EBO& other) noexcept {
 void EBO::Initialize(std::vector<GLuint>& indices) {
     glGenBuffers(1, &this->ID);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID);
     GL_CHECK_ERROR();
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
     GL_CHECK_ERROR();
@@ -37,16 +39,16 @@ EBO::~EBO() {
 
 void EBO::Bind() const {
     if (this->ID == 0) return;
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID);
 }
 
 void EBO::Unbind() const {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void EBO::Destroy() {
     if (this->ID == 0) return;
-    glDeleteBuffers(1, &this->ID);
+    GLState::DeleteBuffers(1, &this->ID);
     GL_CHECK_ERROR_M("Failed to delete EBO");
     this->ID = 0;
     
@@ -55,6 +57,7 @@ void EBO::Destroy() {
 void EBO::UploadData(const void* data, GLsizeiptr size) {
     this->Bind();
     glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, data);
+    GLCounters::CountUpload(size);
     GL_CHECK_ERROR_M("Failed to upload data to EBO");
     this->Unbind();
 }
\ No newline at end of file
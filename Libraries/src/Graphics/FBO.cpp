@@ -1,4 +1,6 @@
 #include "FBO.h"
+#include "GLCounters.h"
+#include "GLState.h"
 
 #include "Logger.h"
 #include "utilities.h"
@@ -34,7 +36,7 @@ void FBO::Swap(FBO& other) noexcept {
 }
 
 void FBO::Destroy() {
-    if (ID != 0) glDeleteFramebuffers(1, &ID);
+    if (ID != 0) GLState::DeleteFramebuffers(1, &ID);
     if (depthBufferID != 0) glDeleteRenderbuffers(1, &depthBufferID);
     
     ID = 0;
@@ -51,12 +53,12 @@ void FBO::Init(int width, int height) {
 
     glGenFramebuffers(1, &ID);
     GL_CHECK_ERROR_M("FBO gen");
-    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO bind init");
     
     TextureColor.SetFramebufferTexture("screenTexture", 0, width, height, this->ID);
     
-    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO rebind init");
     glGenRenderbuffers(1, &depthBufferID);
     GL_CHECK_ERROR_M("FBO depth gen");
@@ -81,14 +83,14 @@ void FBO::Init(int width, int height) {
 
 void FBO::Bind() const {
     if (ID == 0) return;
-    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO bind");
     glViewport(0, 0, width, height);
     GL_CHECK_ERROR_M("FBO viewport");
 }
 
 void FBO::Unbind() const {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
     GL_CHECK_ERROR_M("FBO unbind");
 }
 
@@ -111,7 +113,7 @@ void FBO::Resize(int newWidth, int newHeight) {
     GL_CHECK_ERROR_M("FBO resize depth storage");
     
     // Verify the framebuffer is still complete
-    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO resize bind");
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     GL_CHECK_ERROR_M("FBO resize status check");
@@ -132,9 +134,9 @@ void FBO::BlitFBO(FBO& oFBO) const {
         return;
     }
     
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, oID);
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, oID);
     GL_CHECK_ERROR_M("FBO blit read bind");
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO blit draw bind");
     
     glBlitFramebuffer(0, 0, oWidth, oHeight, 0, 0, width, height,
@@ -153,9 +155,9 @@ void FBO::BlitToScreen(int sWidth, int sHeight) const {
         return;
     }
     
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, ID);
     GL_CHECK_ERROR_M("FBO screen blit read bind");
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     GL_CHECK_ERROR_M("FBO screen blit draw bind");
     
     glBlitFramebuffer(0, 0, width, height, 0, 0, sWidth, sHeight,
@@ -214,9 +216,9 @@ void FBO::RenderScreenQuad(int fWidth, int fHeight) const {
     glViewport(0, 0, fWidth, fHeight);
     GL_CHECK_ERROR_M("FBO screen viewport");
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
     GL_CHECK_ERROR_M("FBO screen fbo unbind");
-    glDisable(GL_DEPTH_TEST);
+    GLState::Disable(GL_DEPTH_TEST);
     GL_CHECK_ERROR_M("FBO screen depth disable");
 
     TextureColor.texUnit(this->screenQuadShader);
@@ -226,15 +228,16 @@ void FBO::RenderScreenQuad(int fWidth, int fHeight) const {
     this->screenQuadVAO.Bind();
 
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    GLCounters::CountDraw(2);
     GL_CHECK_ERROR_M("FBO screen draw");
 
     this->screenQuadVAO.Unbind();
     this->screenQuadShader.Unbind();
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
     GL_CHECK_ERROR_M("FBO screen tex unbind");
     
     
 
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
     GL_CHECK_ERROR_M("FBO screen depth enable");
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "GLBuffer.h"
+#include "GLState.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+size_t GLBuffer::GrowCapacity(size_t capacity, size_t required) {
+    if (required <= capacity) return capacity;
+    return std::max(required, capacity * BUFFER_GROWTH_FACTOR);
+}
+
+bool GLBuffer::Reallocate(GLuint& buffer, size_t copySize, size_t newCapacity, GLenum usage) {
+    GLuint newBuffer = 0;
+    glGenBuffers(1, &newBuffer);
+    if (newBuffer == 0) return false;
+
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, usage);
+
+    if (buffer != 0) {
+        copySize = std::min(copySize, newCapacity);
+        if (copySize > 0) {
+            GLState::BindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, copySize);
+            GLState::BindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        GLState::DeleteBuffers(1, &buffer);
+    }
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GL_CHECK_ERROR_M("Buffer reallocation");
+
+    buffer = newBuffer;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include "Logger.h"
+#include "TraceCapture.h"
+
+namespace
+{
+#ifdef GL_ARB_pipeline_statistics_query
+    const GLenum PIPELINE_TARGETS[PIPELINE_QUERY_COUNT] = {
+        GL_PRIMITIVES_SUBMITTED_ARB, GL_VERTEX_SHADER_INVOCATIONS_ARB,
+        GL_FRAGMENT_SHADER_INVOCATIONS_ARB, GL_CLIPPING_OUTPUT_PRIMITIVES_ARB
+    };
+#endif
+}
+
+bool GLCounters::SupportsPipelineStatistics() {
+#ifdef GL_ARB_pipeline_statistics_query
+    return GLAD_GL_ARB_pipeline_statistics_query != 0;
+#else
+    return false;
+#endif
+}
+
+void GLCounters::EnablePipelineStatistics(bool enable) {
+    Data& data = GetData();
+    if (enable == data.pipelineEnabled) return;
+
+    if (!enable) {
+        Destroy();
+        return;
+    }
+    if (!SupportsPipelineStatistics()) {
+        LOG_WARNING("GL_ARB_pipeline_statistics_query is not supported, pipeline statistics stay off");
+        return;
+    }
+    for (PipelineFrame& frame : data.pipeline) {
+        glGenQueries(PIPELINE_QUERY_COUNT, frame.queries);
+    }
+    data.pipelineEnabled = true;
+    GL_CHECK_ERROR_M("Pipeline statistics queries");
+}
+
+void GLCounters::Destroy() {
+    Data& data = GetData();
+    if (!data.pipelineEnabled) return;
+    EndPipelineQueries();
+    for (PipelineFrame& frame : data.pipeline) {
+        glDeleteQueries(PIPELINE_QUERY_COUNT, frame.queries);
+        frame = PipelineFrame();
+    }
+    data.pipelineEnabled = false;
+    data.pipelineResult = GLFrameCounters();
+}
+
+void GLCounters::EndPipelineQueries() {
+#ifdef GL_ARB_pipeline_statistics_query
+    Data& data = GetData();
+    if (!data.pipelineActive) return;
+    for (GLenum target : PIPELINE_TARGETS) {
+        glEndQuery(target);
+    }
+    data.pipelineActive = false;
+    data.pipeline[data.frame % PIPELINE_QUERY_FRAMES].pending = true;
+#endif
+}
+
+void GLCounters::ReadPipelineQueries(PipelineFrame& frame) {
+    // Stale until this slot yields results, so a skipped read is not shown as current
+    GetData().pipelineResult.pipelineValid = false;
+    if (!frame.pending) return;
+    frame.pending = false;
+
+    // Never wait: a result that is not there yet is skipped
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[PIPELINE_QUERY_COUNT - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available != GL_TRUE) return;
+
+    GLuint64 results[PIPELINE_QUERY_COUNT] = {};
+    for (int i = 0; i < PIPELINE_QUERY_COUNT; i++) {
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &results[i]);
+    }
+    GLFrameCounters& result = GetData().pipelineResult;
+    result.pipelineValid = true;
+    result.primitivesSubmitted = results[0];
+    result.vertexInvocations = results[1];
+    result.fragmentInvocations = results[2];
+    result.clippedPrimitives = results[3];
+}
+
+void GLCounters::BeginFrame() {
+    Data& data = GetData();
+
+    // GLState has not been reset yet, its counters still cover the frame being closed
+    const GLStateStats& state = GLState::GetFrameStats();
+    data.current.stateBinds = state.issued;
+    data.current.programSwitches = state.programs;
+    data.current.textureBinds = state.textures;
+
+    if (data.pipelineEnabled) {
+        EndPipelineQueries();
+        // Statistics of the oldest frame in the ring, its queries are then restarted for this one
+        data.frame++;
+        PipelineFrame& frame = data.pipeline[data.frame % PIPELINE_QUERY_FRAMES];
+        ReadPipelineQueries(frame);
+#ifdef GL_ARB_pipeline_statistics_query
+        for (int i = 0; i < PIPELINE_QUERY_COUNT; i++) {
+            glBeginQuery(PIPELINE_TARGETS[i], frame.queries[i]);
+        }
+        data.pipelineActive = true;
+#endif
+        const GLFrameCounters& pipeline = data.pipelineResult;
+        data.current.pipelineValid = pipeline.pipelineValid;
+        data.current.primitivesSubmitted = pipeline.primitivesSubmitted;
+        data.current.vertexInvocations = pipeline.vertexInvocations;
+        data.current.fragmentInvocations = pipeline.fragmentInvocations;
+        data.current.clippedPrimitives = pipeline.clippedPrimitives;
+    }
+
+    data.last = data.current;
+    data.current = GLFrameCounters();
+
+    if (TraceCapture::IsCapturing()) {
+        static const ProfileZoneID drawCalls = ProfileZones::Intern("GL draw calls");
+        static const ProfileZoneID triangles = ProfileZones::Intern("GL triangles");
+        static const ProfileZoneID uploadBytes = ProfileZones::Intern("GL upload bytes");
+        static const ProfileZoneID stateBinds = ProfileZones::Intern("GL state binds");
+        TraceCapture::AddCounter(drawCalls, data.last.drawCalls);
+        TraceCapture::AddCounter(triangles, static_cast<int64_t>(data.last.triangles));
+        TraceCapture::AddCounter(uploadBytes, static_cast<int64_t>(data.last.uploadBytes));
+        TraceCapture::AddCounter(stateBinds, data.last.stateBinds);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "GLState.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+namespace
+{
+    const GLenum BUFFER_TARGETS[] = {
+        GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+        GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_DRAW_INDIRECT_BUFFER
+    };
+    const GLenum BUFFER_QUERIES[] = {
+        GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING,
+        GL_COPY_READ_BUFFER_BINDING, GL_COPY_WRITE_BUFFER_BINDING, GL_DRAW_INDIRECT_BUFFER_BINDING
+    };
+    const GLenum CAPABILITIES[] = { GL_DEPTH_TEST, GL_BLEND, GL_SCISSOR_TEST, GL_CULL_FACE };
+}
+
+void GLState::Reset(Data& data) {
+    data.program = GLSTATE_UNKNOWN;
+    data.vao = GLSTATE_UNKNOWN;
+    std::fill(std::begin(data.buffers), std::end(data.buffers), GLSTATE_UNKNOWN);
+    std::fill(std::begin(data.uniformBuffers), std::end(data.uniformBuffers), GLSTATE_UNKNOWN);
+    std::fill(std::begin(data.storageBuffers), std::end(data.storageBuffers), GLSTATE_UNKNOWN);
+    data.drawFramebuffer = GLSTATE_UNKNOWN;
+    data.readFramebuffer = GLSTATE_UNKNOWN;
+    data.activeTexture = GLSTATE_UNKNOWN;
+    std::fill(std::begin(data.textures), std::end(data.textures), GLSTATE_UNKNOWN);
+    data.polygonMode = GLSTATE_UNKNOWN;
+    std::fill(std::begin(data.capabilities), std::end(data.capabilities), GLSTATE_UNKNOWN);
+}
+
+int GLState::BufferSlot(GLenum target) {
+    for (int i = 0; i < static_cast<int>(std::size(BUFFER_TARGETS)); i++) {
+        if (BUFFER_TARGETS[i] == target) return i;
+    }
+    return -1;
+}
+
+int GLState::CapabilitySlot(GLenum capability) {
+    for (int i = 0; i < static_cast<int>(std::size(CAPABILITIES)); i++) {
+        if (CAPABILITIES[i] == capability) return i;
+    }
+    return -1;
+}
+
+GLuint* GLState::IndexedSlot(GLenum target, GLuint index) {
+    if (index >= GLSTATE_BUFFER_BINDINGS) return nullptr;
+    if (target == GL_UNIFORM_BUFFER) return &GetData().uniformBuffers[index];
+    if (target == GL_SHADER_STORAGE_BUFFER) return &GetData().storageBuffers[index];
+    return nullptr;
+}
+
+bool GLState::Set(GLuint& shadow, GLuint value) {
+    Data& data = GetData();
+    if (shadow == value) {
+        data.frame.skipped++;
+        return false;
+    }
+    shadow = value;
+    data.frame.issued++;
+    return true;
+}
+
+
+void GLState::UseProgram(GLuint program) {
+    if (!Set(GetData().program, program)) return;
+    GetData().frame.programs++;
+    glUseProgram(program);
+}
+
+void GLState::BindVertexArray(GLuint vao) {
+    Data& data = GetData();
+    if (!Set(data.vao, vao)) return;
+    glBindVertexArray(vao);
+    data.buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = GLSTATE_UNKNOWN;
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer) {
+    int slot = BufferSlot(target);
+    if (slot < 0) {
+        GetData().frame.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Set(GetData().buffers[slot], buffer)) glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    GLuint* shadow = IndexedSlot(target, index);
+    if (shadow == nullptr) {
+        GetData().frame.issued++;
+        glBindBufferBase(target, index, buffer);
+    } else if (Set(*shadow, buffer)) {
+        glBindBufferBase(target, index, buffer);
+    } else {
+        return;
+    }
+    // Binding to an indexed point also binds the generic target
+    int slot = BufferSlot(target);
+    if (slot >= 0) GetData().buffers[slot] = buffer;
+}
+
+void GLState::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    GetData().frame.issued++;
+    glBindBufferRange(target, index, buffer, offset, size);
+    // A later BindBufferBase with the same name must not be skipped
+    GLuint* shadow = IndexedSlot(target, index);
+    if (shadow != nullptr) *shadow = GLSTATE_UNKNOWN;
+    int slot = BufferSlot(target);
+    if (slot >= 0) GetData().buffers[slot] = buffer;
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer) {
+    Data& data = GetData();
+    if (target == GL_FRAMEBUFFER) {
+        if (data.drawFramebuffer == framebuffer && data.readFramebuffer == framebuffer) {
+            data.frame.skipped++;
+            return;
+        }
+        data.drawFramebuffer = framebuffer;
+        data.readFramebuffer = framebuffer;
+        data.frame.issued++;
+        glBindFramebuffer(target, framebuffer);
+        return;
+    }
+    GLuint& shadow = target == GL_READ_FRAMEBUFFER ? data.readFramebuffer : data.drawFramebuffer;
+    if (Set(shadow, framebuffer)) glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::ActiveTexture(GLenum texture) {
+    if (Set(GetData().activeTexture, texture)) glActiveTexture(texture);
+}
+
+void GLState::BindTexture(GLenum target, GLuint texture) {
+    Data& data = GetData();
+    GLuint unit = data.activeTexture - GL_TEXTURE0;
+    if (target != GL_TEXTURE_2D || data.activeTexture == GLSTATE_UNKNOWN || unit >= GLSTATE_TEXTURE_UNITS) {
+        data.frame.issued++;
+        data.frame.textures++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (!Set(data.textures[unit], texture)) return;
+    data.frame.textures++;
+    glBindTexture(target, texture);
+}
+
+void GLState::PolygonMode(GLenum face, GLenum mode) {
+    if (face != GL_FRONT_AND_BACK) {
+        GetData().polygonMode = GLSTATE_UNKNOWN;
+        GetData().frame.issued++;
+        glPolygonMode(face, mode);
+        return;
+    }
+    if (Set(GetData().polygonMode, mode)) glPolygonMode(face, mode);
+}
+
+void GLState::Enable(GLenum capability) {
+    int slot = CapabilitySlot(capability);
+    if (slot < 0) {
+        GetData().frame.issued++;
+        glEnable(capability);
+        return;
+    }
+    if (Set(GetData().capabilities[slot], GL_TRUE)) glEnable(capability);
+}
+
+void GLState::Disable(GLenum capability) {
+    int slot = CapabilitySlot(capability);
+    if (slot < 0) {
+        GetData().frame.issued++;
+        glDisable(capability);
+        return;
+    }
+    if (Set(GetData().capabilities[slot], GL_FALSE)) glDisable(capability);
+}
+
+
+void GLState::DeleteProgram(GLuint program) {
+    Data& data = GetData();
+    // A deleted program stays in use until replaced, force the next UseProgram
+    if (data.program == program) data.program = GLSTATE_UNKNOWN;
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteVertexArrays(GLsizei count, const GLuint* arrays) {
+    Data& data = GetData();
+    for (GLsizei i = 0; i < count; i++) {
+        if (arrays[i] != 0 && data.vao == arrays[i]) {
+            data.vao = 0;
+            data.buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = GLSTATE_UNKNOWN;
+        }
+    }
+    glDeleteVertexArrays(count, arrays);
+}
+
+void GLState::DeleteBuffers(GLsizei count, const GLuint* buffers) {
+    Data& data = GetData();
+    for (GLsizei i = 0; i < count; i++) {
+        if (buffers[i] == 0) continue;
+        std::replace(std::begin(data.buffers), std::end(data.buffers), buffers[i], 0u);
+        std::replace(std::begin(data.uniformBuffers), std::end(data.uniformBuffers), buffers[i], 0u);
+        std::replace(std::begin(data.storageBuffers), std::end(data.storageBuffers), buffers[i], 0u);
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void GLState::DeleteFramebuffers(GLsizei count, const GLuint* framebuffers) {
+    Data& data = GetData();
+    for (GLsizei i = 0; i < count; i++) {
+        if (framebuffers[i] == 0) continue;
+        if (data.drawFramebuffer == framebuffers[i]) data.drawFramebuffer = 0;
+        if (data.readFramebuffer == framebuffers[i]) data.readFramebuffer = 0;
+    }
+    glDeleteFramebuffers(count, framebuffers);
+}
+
+void GLState::DeleteTextures(GLsizei count, const GLuint* textures) {
+    Data& data = GetData();
+    for (GLsizei i = 0; i < count; i++) {
+        if (textures[i] == 0) continue;
+        std::replace(std::begin(data.textures), std::end(data.textures), textures[i], 0u);
+    }
+    glDeleteTextures(count, textures);
+}
+
+
+void GLState::Invalidate() {
+    Reset(GetData());
+}
+
+bool GLState::Validate() {
+    Data& data = GetData();
+    bool valid = true;
+    auto check = [&valid](const char* name, GLuint& shadow, GLint actual) {
+        if (shadow != GLSTATE_UNKNOWN && shadow != static_cast<GLuint>(actual)) {
+            LOG_WARNING("GL state mismatch on ", name, ": shadow ", shadow, ", actual ", actual);
+            valid = false;
+        }
+        shadow = static_cast<GLuint>(actual);
+    };
+
+    GLint value = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+    check("program", data.program, value);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+    check("vertex array", data.vao, value);
+    for (size_t i = 0; i < std::size(BUFFER_QUERIES); i++) {
+        glGetIntegerv(BUFFER_QUERIES[i], &value);
+        check("buffer", data.buffers[i], value);
+    }
+    // GL 4.3 only guarantees 8 storage buffer bindings, querying past the limit is GL_INVALID_VALUE
+    if (data.uniformBindingCount == 0) {
+        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &value);
+        data.uniformBindingCount = std::clamp<GLuint>(static_cast<GLuint>(value), 1, GLSTATE_BUFFER_BINDINGS);
+        glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &value);
+        data.storageBindingCount = std::clamp<GLuint>(static_cast<GLuint>(value), 1, GLSTATE_BUFFER_BINDINGS);
+    }
+    for (GLuint i = 0; i < data.uniformBindingCount; i++) {
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, i, &value);
+        check("uniform buffer binding", data.uniformBuffers[i], value);
+    }
+    for (GLuint i = 0; i < data.storageBindingCount; i++) {
+        glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, i, &value);
+        check("storage buffer binding", data.storageBuffers[i], value);
+    }
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &value);
+    check("draw framebuffer", data.drawFramebuffer, value);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &value);
+    check("read framebuffer", data.readFramebuffer, value);
+
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &value);
+    check("active texture", data.activeTexture, value);
+    for (GLuint unit = 0; unit < GLSTATE_TEXTURE_UNITS; unit++) {
+        if (data.textures[unit] == GLSTATE_UNKNOWN) continue;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
+        check("texture unit", data.textures[unit], value);
+    }
+    glActiveTexture(data.activeTexture);
+
+    GLint polygonMode[2] = { 0, 0 };
+    glGetIntegerv(GL_POLYGON_MODE, polygonMode);
+    check("polygon mode", data.polygonMode, polygonMode[0]);
+    for (size_t i = 0; i < std::size(CAPABILITIES); i++) {
+        check("capability", data.capabilities[i], glIsEnabled(CAPABILITIES[i]));
+    }
+
+    GL_CHECK_ERROR_M("GL state validation");
+    return valid;
+}
+
+void GLState::BeginFrame() {
+    Data& data = GetData();
+    data.lastFrame = data.frame;
+    data.frame = GLStateStats();
+#ifdef DEBUG
+    Validate();
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "IndexBufferCache.h"
+
+#include "Logger.h"
+
+std::shared_ptr<IndexBuffer> IndexBufferCache::Acquire(const IndexBufferKey& key, const std::function<std::vector<GLuint>()>& generate) {
+    auto& cache = GetCache();
+
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        if (std::shared_ptr<IndexBuffer> buffer = it->second.lock()) {
+            return buffer;
+        }
+    }
+
+    std::vector<GLuint> indices = generate();
+    if (indices.empty()) {
+        LOG_WARNING("Empty index buffer generated for ", key.resolution_x, "x", key.resolution_z);
+    }
+
+    std::shared_ptr<IndexBuffer> buffer = std::make_shared<IndexBuffer>();
+    buffer->ebo.Initialize(indices);
+    buffer->ebo.Unbind();
+    buffer->count = static_cast<GLsizei>(indices.size());
+
+    cache[key] = buffer;
+    return buffer;
+}
+
+size_t IndexBufferCache::GetBufferCount() {
+    Purge();
+    return GetCache().size();
+}
+
+void IndexBufferCache::Purge() {
+    auto& cache = GetCache();
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.expired()) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
\ No newline at end of file
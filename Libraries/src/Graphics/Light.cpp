@@ -1,4 +1,7 @@
 #include "Light.h"
+#include "ProfileZones.h"
+
+#include <algorithm>
 
 struct alignas(16) Header {
     int size;
@@ -69,35 +72,89 @@ void LightManager::Swap(LightManager& other) {
     std::swap(this->LightsChanged, other.LightsChanged);
     std::swap(this->AmbientLightChanged, other.AmbientLightChanged);
     std::swap(this->LightSSBO, other.LightSSBO);
+    std::swap(this->LightStaging, other.LightStaging);
+    std::swap(this->visible, other.visible);
 }
 
 void LightManager::initSSBO() { 
     this->LightSSBO.Destroy();
     this->LightSSBO.Initialize(sizeof(Header) + sizeof(lght::LightBlock) * this->lLight.size(), LIGHT_BINDING_POINT);
+    this->LightStaging.Initialize(GL_COPY_READ_BUFFER, sizeof(Header) + sizeof(lght::LightBlock) * 16);
 }
 
 void LightManager::Destroy() { 
     this->LightSSBO.Destroy();
+    this->LightStaging.Destroy();
 }
 
 void LightManager::updateSSBO() {
-    if (this->LightsChanged) {
-        this->LightSSBO.ResizePreserveData(sizeof(Header) + sizeof(lght::LightBlock) * this->lLight.size());
+    this->UploadLights(nullptr);
+}
+
+void LightManager::updateSSBO(const Frustum& frustum) {
+    this->UploadLights(&frustum);
+}
+
+void LightManager::UploadLights(const Frustum* frustum) {
+    PROFILE_SCOPE("LightUpload");
+    this->visibleScratch.clear();
+    for (size_t i = 0; i < this->lLight.size(); i++) {
+        const lght::Light& light = this->lLight[i];
+        if (light.type == lght::NONE) continue;
+        if (frustum != nullptr) {
+            float range = lght::Range(light);
+            if (range == 0.0f) continue;
+            if (range > 0.0f && !frustum->IntersectsSphere(light.position, range)) continue;
+        }
+        this->visibleScratch.push_back(i);
     }
 
-    if (this->LightsChanged || this->AmbientLightChanged) {
-        Header hHeader = { .size = this->size, .ambientLight = this->ambientLight };
-        this->LightSSBO.UploadData(&hHeader, sizeof(Header), 0);
-        this->LightsChanged = false;
-        this->AmbientLightChanged = false;
+    if (this->LightsChanged || this->visibleScratch != this->visible) {
+        // The packing moved, everything is rewritten in one copy
+        std::swap(this->visible, this->visibleScratch);
+        this->LightSSBO.Resize(sizeof(Header) + sizeof(lght::LightBlock) * this->visible.size());
+
+        Header hHeader = { .size = static_cast<int>(this->visible.size()), .ambientLight = this->ambientLight };
+        this->LightStaging.Stage(&hHeader, sizeof(Header), this->LightSSBO.getBufferID(), 0);
+        this->UploadRange(0, this->visible.size());
+    } else {
+        if (this->AmbientLightChanged) {
+            Header hHeader = { .size = static_cast<int>(this->visible.size()), .ambientLight = this->ambientLight };
+            this->LightStaging.Stage(&hHeader, sizeof(Header), this->LightSSBO.getBufferID(), 0);
+        }
+
+        // Dirty lights are grouped in runs, a short clean gap is cheaper to
+        // upload again than a separate copy
+        size_t k = 0;
+        while (k < this->visible.size()) {
+            if (!this->LightChanged[this->visible[k]]) {
+                k++;
+                continue;
+            }
+            size_t end = k + 1;
+            for (size_t j = end; j < this->visible.size() && j - end <= LIGHT_UPLOAD_MAX_GAP; j++) {
+                if (this->LightChanged[this->visible[j]]) end = j + 1;
+            }
+            this->UploadRange(k, end);
+            k = end;
+        }
     }
 
-    for (size_t i = 0; i < this->lLight.size(); i++) {
-        if (!this->LightChanged[i]) continue;
-        lght::LightBlock l = this->lLight[i];
-        this->LightSSBO.UploadData(&l, sizeof(lght::LightBlock), i * sizeof(lght::LightBlock) + sizeof(Header));
-        this->LightChanged[i] = false;
-    } 
+    // Hidden lights are packed again with their current data once they show up
+    std::fill(this->LightChanged.begin(), this->LightChanged.end(), false);
+    this->LightsChanged = false;
+    this->AmbientLightChanged = false;
+}
+
+void LightManager::UploadRange(size_t begin, size_t end) {
+    if (begin >= end) return;
+
+    this->packed.resize(end - begin);
+    for (size_t k = begin; k < end; k++) {
+        this->packed[k - begin] = this->lLight[this->visible[k]];
+    }
+    this->LightStaging.Stage(this->packed.data(), sizeof(lght::LightBlock) * this->packed.size(),
+        this->LightSSBO.getBufferID(), sizeof(Header) + sizeof(lght::LightBlock) * begin);
 }
 
 void LightManager::BindSSBO() const { 
@@ -127,9 +184,12 @@ void LightManager::RemoveLight(size_t index) {
     if (index >= this->lLight.size()) return;
 
     this->LightsChanged = true;
-    this->LightChanged[index] = true;
+    // The last light moves into the slot, its flag moves with it and the slot must be re-uploaded
     this->lLight[index] = this->lLight.back();
+    this->LightChanged[index] = true;
     this->lLight.pop_back();
+    this->LightChanged.pop_back();
+    this->size--;
 }
 
 
@@ -1,4 +1,5 @@
 #include "Mesh.h"
+#include "GLState.h"
 
 Mesh::Mesh(std::vector<GLfloat> vertices, std::vector<GLuint> indices, std::vector<GLuint> sizeAttrib) {
     this->Initialize(vertices, indices, sizeAttrib);
@@ -9,15 +10,23 @@ Mesh::Mesh(std::vector<GLfloat> vertices, std::vector<GLuint> indices, std::vect
 }
 
 Mesh::Mesh(const Mesh& mesh) noexcept {
-    this->Initialize(mesh.vertices, mesh.indices, mesh.sizeAttrib, mesh.instances, mesh.SizeAttribInstance);
+    if (mesh.sharedIndices) {
+        this->Initialize(mesh.vertices, mesh.sharedIndices, mesh.sizeAttrib);
+    } else {
+        this->Initialize(mesh.vertices, mesh.indices, mesh.sizeAttrib, mesh.instances, mesh.SizeAttribInstance);
+    }
 }
 
 Mesh Mesh::operator=(const Mesh& mesh) noexcept {
-    this->Initialize(mesh.vertices, mesh.indices, mesh.sizeAttrib, mesh.instances, mesh.SizeAttribInstance);
+    if (mesh.sharedIndices) {
+        this->Initialize(mesh.vertices, mesh.sharedIndices, mesh.sizeAttrib);
+    } else {
+        this->Initialize(mesh.vertices, mesh.indices, mesh.sizeAttrib, mesh.instances, mesh.SizeAttribInstance);
+    }
     return *this;
 }
 
-Mesh::Mesh(Mesh&& mesh) noexcept : position(0.0f), scale(1.0f), rotation(0.0f), instancing(1) {
+Mesh::Mesh(Mesh&& mesh) noexcept : indexCount(0), position(0.0f), scale(1.0f), rotation(0.0f), instancing(1) {
     this->Swap(mesh);
 }
 
@@ -32,13 +41,20 @@ Mesh Mesh::operator=(Mesh&& mesh) noexcept {
 void Mesh::Swap(Mesh& mesh) noexcept {
     std::swap(this->vertices, mesh.vertices);
     std::swap(this->indices, mesh.indices);
+    std::swap(this->sharedIndices, mesh.sharedIndices);
+    std::swap(this->indexCount, mesh.indexCount);
     std::swap(this->sizeAttrib, mesh.sizeAttrib);
     std::swap(this->instances, mesh.instances);
     std::swap(this->SizeAttribInstance, mesh.SizeAttribInstance);
     std::swap(this->instancing, mesh.instancing);
     std::swap(this->bVAO, mesh.bVAO);
-    std::swap(this->bUBO, mesh.bUBO);
+    std::swap(this->pool, mesh.pool);
+    std::swap(this->poolRange, mesh.poolRange);
+    std::swap(this->transformSlot, mesh.transformSlot);
     std::swap(this->shader, mesh.shader);
+    std::swap(this->samplersAssigned, mesh.samplersAssigned);
+    std::swap(this->uniformCache, mesh.uniformCache);
+    std::swap(this->wireframeUniform, mesh.wireframeUniform);
     std::swap(this->position, mesh.position);
     std::swap(this->scale, mesh.scale);
     std::swap(this->rotation, mesh.rotation);
@@ -49,21 +65,55 @@ void Mesh::Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices
 }
 
 void Mesh::Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices, std::vector<GLuint> sizeAttrib, std::vector<GLfloat> instances, std::vector<GLuint> SizeAttribInstance) {
-    this->vertices = vertices;
-    this->indices = indices;
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->sharedIndices.reset();
+    this->indexCount = this->indices.size();
     this->sizeAttrib = sizeAttrib;
     this->instances = instances;
     this->SizeAttribInstance = SizeAttribInstance;
-    
-    if (instances.empty()) {
+
+    EBO bEBO(this->indices);
+    this->Build(bEBO);
+}
+
+void Mesh::Initialize(std::vector<GLfloat> vertices, std::shared_ptr<IndexBuffer> indexBuffer, std::vector<GLuint> sizeAttrib) {
+    if (!indexBuffer) {
+        LOG_ERROR(1, "Mesh initialized without index buffer");
+        return;
+    }
+    this->vertices = std::move(vertices);
+    this->indices.clear();
+    this->sharedIndices = std::move(indexBuffer);
+    this->indexCount = this->sharedIndices->count;
+    this->sizeAttrib = sizeAttrib;
+    this->instances.clear();
+    this->SizeAttribInstance.clear();
+    this->instancing = 1;
+
+    if (this->pool) this->pool->Free(this->poolRange);
+    this->bVAO.Destroy();
+    this->pool = VertexPool::Acquire(this->sizeAttrib, this->sharedIndices);
+    if (!this->pool->Allocate(this->vertices, this->poolRange)) {
+        LOG_ERROR(1, "Mesh vertex pool allocation failed");
+        this->pool.reset();
+        this->poolRange = VertexRange();
+    }
+    if (this->transformSlot == INVALID_TRANSFORM_SLOT) {
+        this->transformSlot = ObjectTransforms::Allocate();
+    }
+}
+
+void Mesh::Build(const EBO& bEBO) {
+    if (this->instances.empty()) {
         this->instancing = 1;
     } else {
         // Calculate instances based on total components per instance
         int componentsPerInstance = 0;
-        for (GLuint size : SizeAttribInstance) {
+        for (GLuint size : this->SizeAttribInstance) {
             componentsPerInstance += size;
         }
-        this->instancing = (componentsPerInstance > 0) ? instances.size() / componentsPerInstance : 1;
+        this->instancing = (componentsPerInstance > 0) ? this->instances.size() / componentsPerInstance : 1;
     }
     
     
@@ -74,38 +124,42 @@ void Mesh::Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices
     this->bVAO.Bind();
 
     VBO bVBO(this->vertices);
-    EBO bEBO(this->indices);
+    bEBO.Bind();
 
     int numComponents = 0;
-    for (GLuint i = 0; i < sizeAttrib.size(); i++) {
-        numComponents += sizeAttrib[i];
+    for (GLuint i = 0; i < this->sizeAttrib.size(); i++) {
+        numComponents += this->sizeAttrib[i];
     }
 
     int offset = 0; 
     GLuint i = 0;
-    for (; i < sizeAttrib.size(); i++) {
-        this->bVAO.LinkAttrib(bVBO, i, sizeAttrib[i], GL_FLOAT, numComponents * sizeof(GLfloat), (void*)(offset * sizeof(GLfloat)));
-        offset += sizeAttrib[i];
+    for (; i < this->sizeAttrib.size(); i++) {
+        this->bVAO.LinkAttrib(bVBO, i, this->sizeAttrib[i], GL_FLOAT, numComponents * sizeof(GLfloat), (void*)(offset * sizeof(GLfloat)));
+        offset += this->sizeAttrib[i];
+    }
+    // Instanced meshes get their draw ID as a constant attribute at draw time
+    if (this->instances.empty()) {
+        ObjectTransforms::LinkDrawID();
     }
 
-    if (!instances.empty()) {
-        VBO instanceVBO(instances);
+    if (!this->instances.empty()) {
+        VBO instanceVBO(this->instances);
         instanceVBO.Bind();
 
         numComponents = 0;
-        for (GLuint i = 0; i < SizeAttribInstance.size(); i++) {
-            numComponents += SizeAttribInstance[i];
+        for (GLuint i = 0; i < this->SizeAttribInstance.size(); i++) {
+            numComponents += this->SizeAttribInstance[i];
         }
 
         offset = 0;
-        i = sizeAttrib.size();
-        for (; i < sizeAttrib.size() + SizeAttribInstance.size(); i++) {
-            this->bVAO.LinkAttrib(instanceVBO, i, SizeAttribInstance[i - sizeAttrib.size()], GL_FLOAT, numComponents * sizeof(GLfloat), (void*)(offset * sizeof(GLfloat)));
-            offset += SizeAttribInstance[i - sizeAttrib.size()];
+        i = this->sizeAttrib.size();
+        for (; i < this->sizeAttrib.size() + this->SizeAttribInstance.size(); i++) {
+            this->bVAO.LinkAttrib(instanceVBO, i, this->SizeAttribInstance[i - this->sizeAttrib.size()], GL_FLOAT, numComponents * sizeof(GLfloat), (void*)(offset * sizeof(GLfloat)));
+            offset += this->SizeAttribInstance[i - this->sizeAttrib.size()];
         }
 
-        i = sizeAttrib.size();
-        for (; i < sizeAttrib.size() + SizeAttribInstance.size(); i++) {
+        i = this->sizeAttrib.size();
+        for (; i < this->sizeAttrib.size() + this->SizeAttribInstance.size(); i++) {
             glVertexAttribDivisor(i, 1);
         }
         
@@ -119,85 +173,81 @@ void Mesh::Initialize(std::vector<GLfloat> vertices, std::vector<GLuint> indices
         bEBO.Unbind();
     }
 
-    this->bUBO.initialize(sizeof(glm::mat4), MESH_MODEL_BINDING_POINT);
+    if (this->pool) {
+        this->pool->Free(this->poolRange);
+        this->pool.reset();
+        this->poolRange = VertexRange();
+    }
+    if (this->transformSlot == INVALID_TRANSFORM_SLOT) {
+        this->transformSlot = ObjectTransforms::Allocate();
+    }
 }
 
 
 void Mesh::Destroy() {
     this->bVAO.Destroy();
-    this->bUBO.Destroy();
+    if (this->pool) {
+        this->pool->Free(this->poolRange);
+        this->pool.reset();
+        this->poolRange = VertexRange();
+    }
+    this->sharedIndices.reset();
+    if (this->transformSlot != INVALID_TRANSFORM_SLOT) {
+        ObjectTransforms::Free(this->transformSlot);
+        this->transformSlot = INVALID_TRANSFORM_SLOT;
+    }
     this->shader.Destroy();
     for (GLuint i = 0; i < this->textures.size(); i++) {
         this->textures[i].Destroy();
     }
     this->textures.clear();
+    this->samplersAssigned = false;
     this->FreeCache();
 }
 
 void Mesh::AddTexture(Texture texture) {
     this->textures.push_back(texture.Copy());
+    this->samplersAssigned = false;
 }
 
 void Mesh::AddTexture(const char* image, const char* name, GLenum format, GLenum pixelType) {
     GLuint slot = this->textures.size();
     this->textures.push_back(Texture(image, name, slot, format, pixelType));
+    this->samplersAssigned = false;
 }
 
 
-void Mesh::Render(Camera& camera) {
+void Mesh::Submit(RenderQueue& queue, const Camera& camera) {
     if (!this->shader.IsCompiled()) {
         LOG_WARNING("Shader not compiled");
         return;
     }
-    this->shader.Bind();
-    this->bVAO.Bind();
-    for (GLuint i = 0; i < this->textures.size(); i++) {
-        this->textures[i].texUnit(this->shader);
-        
-        this->textures[i].Bind();
-    }
-    this->bUBO.BindToBindingPoint();
-    this->Draw();
-    if (camera.IsWireframe()) {
-        GLint wireframe = GL_TRUE;
-        this->InitUniform1i("wireframe", &wireframe);
-        this->Draw(true);
-        wireframe = GL_FALSE;
-        this->InitUniform1i("wireframe", &wireframe);
-    }
-    
-    this->bVAO.Unbind();
-    this->shader.Unbind();
-    this->bUBO.Unbind();
-    for (GLuint i = 0; i < this->textures.size(); i++) {
-        this->textures[i].Unbind();
-    }
-}
-
-void Mesh::Draw(bool wireframe) const {
-    if (wireframe) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        // Optional: disable depth testing for wireframe to avoid z-fighting
-        // glDisable(GL_DEPTH_TEST);
-    } else {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        // glEnable(GL_DEPTH_TEST);
+    if (!this->samplersAssigned) {
+        for (GLuint i = 0; i < this->textures.size(); i++) {
+            this->textures[i].texUnit(this->shader);
+        }
+        this->samplersAssigned = true;
     }
-
-    if (this->instancing > 1) {
-        glDrawElementsInstanced(GL_TRIANGLES, this->indices.size(), GL_UNSIGNED_INT, 0, this->instancing);
-    } else {
-        glDrawElements(GL_TRIANGLES, this->indices.size(), GL_UNSIGNED_INT, 0);
+    if (this->wireframeUniform == INVALID_UNIFORM_HANDLE) {
+        this->wireframeUniform = this->GetUniformHandle("wireframe");
     }
 
-    // Reset to fill mode after drawing
-    if (wireframe) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glEnable(GL_DEPTH_TEST);
-    }
+    DrawItem item;
+    item.program = this->shader.GetID();
+    item.vao = this->pool ? this->pool->GetVAO() : this->bVAO.GetID();
+    item.baseVertex = this->poolRange.baseVertex;
+    item.transformSlot = this->transformSlot;
+    item.textures = this->textures.data();
+    item.textureCount = this->textures.size();
+    item.indexCount = this->indexCount;
+    item.instanceCount = this->instancing;
+    item.mesh = this;
+    item.wireframeUniform = this->wireframeUniform;
+    item.key = RenderQueue::MakeSortKey(item, glm::distance(camera.GetPosition(), this->position) / camera.GetFarPlane());
+    queue.Submit(item);
 }
 
-void Mesh::UpdateUBO() {
+void Mesh::UpdateTransform() {
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, this->position);
     model = glm::rotate(model, glm::radians(this->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -205,5 +255,5 @@ void Mesh::UpdateUBO() {
     model = glm::rotate(model, glm::radians(this->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
     model = glm::scale(model, this->scale);
 
-    this->bUBO.uploadData(glm::value_ptr(model), sizeof(glm::mat4));
+    ObjectTransforms::Set(this->transformSlot, model);
 }
@@ -1,90 +1,87 @@
 #include "Mesh.h"
 
-void Mesh::InitUniform4f(const char* uniform, const GLfloat* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 4 * sizeof(GLfloat))) return;
-    this->shader.Bind();
-    glUniform4fv(CachedUniformLocation(sUni), 1, data);
+UniformHandle Mesh::GetUniformHandle(const char* uniform) {
+    for (size_t i = 0; i < this->uniformCache.size(); i++) {
+        if (this->uniformCache[i].name == uniform) return static_cast<UniformHandle>(i);
+    }
+    if (this->uniformCache.size() >= INVALID_UNIFORM_HANDLE) {
+        LOG_ERROR(1, "Too many uniforms on mesh");
+        return INVALID_UNIFORM_HANDLE;
+    }
+    this->uniformCache.emplace_back();
+    this->uniformCache.back().name = uniform;
+    return static_cast<UniformHandle>(this->uniformCache.size() - 1);
 }
 
-void Mesh::InitUniform3f(const char* uniform, const GLfloat* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 3 * sizeof(GLfloat))) return;
-    this->shader.Bind();
-    glUniform3fv(CachedUniformLocation(sUni), 1, data);
-}
+// Returns the location to upload to, or -1 when the value is unchanged or unknown
+GLint Mesh::CacheUniform(UniformHandle handle, const void* data, size_t size) {
+    if (handle >= this->uniformCache.size()) return -1;
+    UniformCache& cache = this->uniformCache[handle];
+    GLuint ID = this->shader.GetID();
+    size = size > 64 ? 64 : size;
+
+    if (cache.shaderID != ID || cache.location == -2) {
+        cache.shaderID = ID;
+        cache.location = glGetUniformLocation(ID, cache.name.c_str());
+        if (cache.location == -1) LOG_ERROR(1, "Uniform ", cache.name, " not found");
+    } else if (cache.size == size && memcmp(cache.data.data(), data, size) == 0) {
+        return -1;
+    }
+
+    cache.size = static_cast<uint8_t>(size);
+    memcpy(cache.data.data(), data, size);
+    if (cache.location < 0) return -1;
 
-void Mesh::InitUniform2f(const char* uniform, const GLfloat* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 2 * sizeof(GLfloat))) return;
     this->shader.Bind();
-    glUniform2fv(CachedUniformLocation(sUni), 1, data);
+    return cache.location;
 }
 
-void Mesh::InitUniform1f(const char* uniform, const GLfloat* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, sizeof(GLfloat))) return;
-    this->shader.Bind();
-    glUniform1fv(CachedUniformLocation(sUni), 1, data);
+void Mesh::SetUniform4f(UniformHandle handle, const GLfloat* data) {
+    GLint location = this->CacheUniform(handle, data, 4 * sizeof(GLfloat));
+    if (location >= 0) glUniform4fv(location, 1, data);
 }
 
-void Mesh::InitUniform4i(const char* uniform, const GLint* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 4 * sizeof(GLint))) return;
-    this->shader.Bind();
-    glUniform4iv(CachedUniformLocation(sUni), 1, data);
+void Mesh::SetUniform3f(UniformHandle handle, const GLfloat* data) {
+    GLint location = this->CacheUniform(handle, data, 3 * sizeof(GLfloat));
+    if (location >= 0) glUniform3fv(location, 1, data);
 }
 
-void Mesh::InitUniform3i(const char* uniform, const GLint* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 3 * sizeof(GLint))) return;
-    this->shader.Bind();
-    glUniform3iv(CachedUniformLocation(sUni), 1, data);
+void Mesh::SetUniform2f(UniformHandle handle, const GLfloat* data) {
+    GLint location = this->CacheUniform(handle, data, 2 * sizeof(GLfloat));
+    if (location >= 0) glUniform2fv(location, 1, data);
 }
 
-void Mesh::InitUniform2i(const char* uniform, const GLint* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 2 * sizeof(GLint))) return;
-    this->shader.Bind();
-    glUniform2iv(CachedUniformLocation(sUni), 1, data);
+void Mesh::SetUniform1f(UniformHandle handle, const GLfloat* data) {
+    GLint location = this->CacheUniform(handle, data, sizeof(GLfloat));
+    if (location >= 0) glUniform1fv(location, 1, data);
 }
 
-void Mesh::InitUniform1i(const char* uniform, const GLint* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, sizeof(GLint))) return;
-    this->shader.Bind();
-    glUniform1iv(CachedUniformLocation(sUni), 1, data);
+void Mesh::SetUniform4i(UniformHandle handle, const GLint* data) {
+    GLint location = this->CacheUniform(handle, data, 4 * sizeof(GLint));
+    if (location >= 0) glUniform4iv(location, 1, data);
 }
 
-void Mesh::InitUniformMatrix4f(const char* uniform, const GLfloat* data) {
-    std::string sUni(uniform);
-    if (!CacheUniform(sUni, (void*)data, 4 * 4 * sizeof(GLfloat))) return;
-    this->shader.Bind();
-    glUniformMatrix4fv(CachedUniformLocation(sUni), 1, GL_FALSE, data);
+void Mesh::SetUniform3i(UniformHandle handle, const GLint* data) {
+    GLint location = this->CacheUniform(handle, data, 3 * sizeof(GLint));
+    if (location >= 0) glUniform3iv(location, 1, data);
 }
 
-GLint Mesh::CachedUniformLocation(const std::string& uniform) {
-    auto& cache = this->uniformCache[uniform];
-    GLuint ID = this->shader.GetID();
-    if (cache.location != -2 && cache.shaderID == ID) return cache.location;
-    cache.shaderID = ID;
-    cache.location = glGetUniformLocation(ID, uniform.c_str());
-    if (cache.location == -1) LOG_ERROR(1, "Uniform ", uniform, " not found");
-    return cache.location;
+void Mesh::SetUniform2i(UniformHandle handle, const GLint* data) {
+    GLint location = this->CacheUniform(handle, data, 2 * sizeof(GLint));
+    if (location >= 0) glUniform2iv(location, 1, data);
 }
 
-bool Mesh::CacheUniform(const std::string& uniform, void* data, size_t size) {
-    auto& cache = this->uniformCache[uniform];
-    size = size > 64 ? 64 : size;
-    if (cache.location > -1 && cache.shaderID == this->shader.GetID() && cache.size == size && memcmp(cache.data.data(), data, size) == 0) 
-        return false;
-        
-    cache.size = size;
-    memcpy(cache.data.data(), data, size);
+void Mesh::SetUniform1i(UniformHandle handle, const GLint* data) {
+    GLint location = this->CacheUniform(handle, data, sizeof(GLint));
+    if (location >= 0) glUniform1iv(location, 1, data);
+}
 
-    return true;
+void Mesh::SetUniformMatrix4f(UniformHandle handle, const GLfloat* data) {
+    GLint location = this->CacheUniform(handle, data, 4 * 4 * sizeof(GLfloat));
+    if (location >= 0) glUniformMatrix4fv(location, 1, GL_FALSE, data);
 }
 
 void Mesh::FreeCache() {
     this->uniformCache.clear();
+    this->wireframeUniform = INVALID_UNIFORM_HANDLE;
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ObjectTransforms.h"
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include <algorithm>
+
+uint32_t ObjectTransforms::Allocate() {
+    Data& data = GetData();
+    uint32_t slot;
+    if (!data.freeSlots.empty()) {
+        slot = data.freeSlots.back();
+        data.freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(data.models.size());
+        data.models.push_back(glm::mat4(1.0f));
+    }
+    Set(slot, glm::mat4(1.0f));
+    return slot;
+}
+
+void ObjectTransforms::Free(uint32_t slot) {
+    Data& data = GetData();
+    if (slot >= data.models.size()) return;
+    data.freeSlots.push_back(slot);
+}
+
+void ObjectTransforms::Set(uint32_t slot, const glm::mat4& model) {
+    Data& data = GetData();
+    if (slot >= data.models.size()) return;
+    data.models[slot] = model;
+    if (data.dirtyBegin == data.dirtyEnd) {
+        data.dirtyBegin = slot;
+        data.dirtyEnd = slot + 1;
+    } else {
+        data.dirtyBegin = std::min<size_t>(data.dirtyBegin, slot);
+        data.dirtyEnd = std::max<size_t>(data.dirtyEnd, slot + 1);
+    }
+}
+
+void ObjectTransforms::Upload() {
+    Data& data = GetData();
+    if (!data.ssbo.isInitialized()) {
+        size_t slots = std::max<size_t>(data.models.size(), OBJECT_TRANSFORM_INITIAL_SLOTS);
+        data.ssbo.Initialize(slots * sizeof(glm::mat4), OBJECT_TRANSFORM_BINDING_POINT);
+        data.dirtyBegin = 0;
+        data.dirtyEnd = data.models.size();
+    }
+
+    if (!data.staging.isInitialized()) {
+        data.staging.Initialize(GL_COPY_READ_BUFFER, OBJECT_TRANSFORM_INITIAL_SLOTS * sizeof(glm::mat4));
+    }
+
+    if (data.dirtyBegin < data.dirtyEnd) {
+        if (data.models.size() * sizeof(glm::mat4) > data.ssbo.getSize()) {
+            data.ssbo.ResizePreserveData(data.models.size() * sizeof(glm::mat4));
+        }
+        data.staging.Stage(data.models.data() + data.dirtyBegin, (data.dirtyEnd - data.dirtyBegin) * sizeof(glm::mat4),
+            data.ssbo.getBufferID(), data.dirtyBegin * sizeof(glm::mat4));
+        data.dirtyBegin = data.dirtyEnd = 0;
+    }
+    data.ssbo.BindToPoint();
+}
+
+void ObjectTransforms::UploadDrawIDs(const std::vector<GLuint>& slots) {
+    Data& data = GetData();
+    if (data.drawIDBuffer == 0 || slots.empty()) return;
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, data.drawIDBuffer);
+    if (slots.size() > data.drawIDCapacity) {
+        data.drawIDCapacity = std::max(slots.size(), data.drawIDCapacity * 2);
+    }
+    // Orphan the previous frame's IDs instead of waiting on them
+    glBufferData(GL_ARRAY_BUFFER, data.drawIDCapacity * sizeof(GLuint), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, slots.size() * sizeof(GLuint), slots.data());
+    GLCounters::CountUpload(slots.size() * sizeof(GLuint));
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_ERROR_M("Draw ID upload");
+}
+
+void ObjectTransforms::LinkDrawID() {
+    Data& data = GetData();
+    if (data.drawIDBuffer == 0) {
+        glGenBuffers(1, &data.drawIDBuffer);
+        data.drawIDCapacity = OBJECT_TRANSFORM_INITIAL_SLOTS;
+        GLState::BindBuffer(GL_ARRAY_BUFFER, data.drawIDBuffer);
+        glBufferData(GL_ARRAY_BUFFER, data.drawIDCapacity * sizeof(GLuint), nullptr, GL_STREAM_DRAW);
+    }
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, data.drawIDBuffer);
+    glVertexAttribIPointer(DRAW_ID_ATTRIBUTE_LOCATION, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glEnableVertexAttribArray(DRAW_ID_ATTRIBUTE_LOCATION);
+    glVertexAttribDivisor(DRAW_ID_ATTRIBUTE_LOCATION, 1);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_ERROR_M("Draw ID link");
+}
+
+void ObjectTransforms::Destroy() {
+    Data& data = GetData();
+    data.ssbo.Destroy();
+    data.staging.Destroy();
+    if (data.drawIDBuffer != 0) {
+        GLState::DeleteBuffers(1, &data.drawIDBuffer);
+        data.drawIDBuffer = 0;
+    }
+    data.drawIDCapacity = 0;
+    data.models.clear();
+    data.freeSlots.clear();
+    data.dirtyBegin = data.dirtyEnd = 0;
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "RenderQueue.h"
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include "Mesh.h"
+#include "ObjectTransforms.h"
+#include "ProfileZones.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RenderQueue::Submit(const DrawItem& item) {
+    if (item.program == 0 || item.vao == 0 || item.indexCount == 0) return;
+    this->order.emplace_back(item.key, static_cast<uint32_t>(this->items.size()));
+    this->items.push_back(item);
+}
+
+void RenderQueue::Clear() {
+    this->items.clear();
+    this->order.clear();
+    this->batches.clear();
+    this->commands.clear();
+    this->drawIDs.clear();
+}
+
+void RenderQueue::Destroy() {
+    this->Clear();
+    if (this->indirectBuffer != 0) {
+        GLState::DeleteBuffers(1, &this->indirectBuffer);
+        this->indirectBuffer = 0;
+    }
+    this->indirectCapacity = 0;
+}
+
+uint64_t RenderQueue::MakeSortKey(const DrawItem& item, float depth) {
+    // FNV-1a over the texture names, folded to 16 bits
+    uint32_t textureSet = 2166136261u;
+    for (GLuint i = 0; i < item.textureCount; i++) {
+        textureSet = (textureSet ^ item.textures[i].GetID()) * 16777619u;
+    }
+    textureSet = item.textureCount == 0 ? 0 : (textureSet ^ (textureSet >> 16)) & 0xFFFF;
+
+    // Front to back inside a state group
+    uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * 65535.0f);
+
+    return (static_cast<uint64_t>(item.program & 0xFFFF) << 48)
+         | (static_cast<uint64_t>(textureSet) << 32)
+         | (static_cast<uint64_t>(item.vao & 0xFFFF) << 16)
+         | quantizedDepth;
+}
+
+bool RenderQueue::SameState(const DrawItem& a, const DrawItem& b) {
+    if (a.program != b.program || a.vao != b.vao || a.textureCount != b.textureCount) return false;
+    for (GLuint i = 0; i < a.textureCount; i++) {
+        if (a.textures[i].GetID() != b.textures[i].GetID() || a.textures[i].GetSlot() != b.textures[i].GetSlot()) return false;
+    }
+    return true;
+}
+
+void RenderQueue::BuildBatches() {
+    for (const auto& [key, index] : this->order) {
+        const DrawItem& item = this->items[index];
+        if (item.instanceCount > 1) {
+            this->batches.push_back({ index, 0, 0 });
+            continue;
+        }
+
+        const uint32_t command = static_cast<uint32_t>(this->commands.size());
+        this->commands.push_back({ static_cast<GLuint>(item.indexCount), 1, 0, item.baseVertex, command });
+        this->drawIDs.push_back(item.transformSlot);
+
+        if (!this->batches.empty()) {
+            Batch& last = this->batches.back();
+            if (last.commandCount > 0 && SameState(this->items[last.item], item)) {
+                last.commandCount++;
+                continue;
+            }
+        }
+        this->batches.push_back({ index, command, 1 });
+    }
+}
+
+void RenderQueue::UploadCommands() {
+    if (this->commands.empty()) return;
+
+    if (this->indirectBuffer == 0) {
+        glGenBuffers(1, &this->indirectBuffer);
+    }
+    GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, this->indirectBuffer);
+    this->indirectCapacity = std::max(this->indirectCapacity, this->commands.size());
+    // Orphan the previous frame's commands instead of waiting on them
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, this->indirectCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, this->commands.size() * sizeof(DrawElementsIndirectCommand), this->commands.data());
+    GLCounters::CountUpload(this->commands.size() * sizeof(DrawElementsIndirectCommand));
+    GL_CHECK_ERROR_M("Render queue indirect upload");
+
+    ObjectTransforms::UploadDrawIDs(this->drawIDs);
+}
+
+void RenderQueue::ResetState() {
+    this->boundProgram = 0;
+    this->boundVAO = 0;
+    std::fill(std::begin(this->boundTextures), std::end(this->boundTextures), 0);
+}
+
+void RenderQueue::Flush(bool wireframe) {
+    PROFILE_SCOPE("QueueFlush");
+    this->stats = RenderQueueStats();
+    this->stats.items = static_cast<uint32_t>(this->items.size());
+    if (this->items.empty()) return;
+
+    std::sort(this->order.begin(), this->order.end());
+    this->BuildBatches();
+
+    ObjectTransforms::Upload();
+    this->UploadCommands();
+
+    // Whatever was bound before the flush is unknown to the queue
+    this->ResetState();
+    GLState::PolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    for (const Batch& batch : this->batches) {
+        this->Execute(batch);
+    }
+
+    if (wireframe) {
+        GLState::PolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        GLint enabled = GL_TRUE;
+        GLint disabled = GL_FALSE;
+        for (const Batch& batch : this->batches) {
+            DrawItem& item = this->items[batch.item];
+            if (item.mesh == nullptr) continue;
+            // Uniforms are program state, setting them through the first mesh covers the batch
+            item.mesh->SetUniform1i(item.wireframeUniform, &enabled);
+            this->boundProgram = item.program;
+            this->Execute(batch);
+            item.mesh->SetUniform1i(item.wireframeUniform, &disabled);
+        }
+        GLState::PolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        GLState::Enable(GL_DEPTH_TEST);
+    }
+
+    GLState::BindVertexArray(0);
+    GLState::UseProgram(0);
+    GL_CHECK_ERROR_M("Render queue flush");
+
+    this->Clear();
+}
+
+void RenderQueue::BindState(const DrawItem& item) {
+    if (item.program != this->boundProgram) {
+        GLState::UseProgram(item.program);
+        this->boundProgram = item.program;
+        this->stats.programBinds++;
+    }
+    if (item.vao != this->boundVAO) {
+        GLState::BindVertexArray(item.vao);
+        this->boundVAO = item.vao;
+        this->stats.vaoBinds++;
+    }
+    for (GLuint i = 0; i < item.textureCount; i++) {
+        const Texture& texture = item.textures[i];
+        GLuint slot = texture.GetSlot();
+        if (slot < RENDER_QUEUE_TEXTURE_UNITS && this->boundTextures[slot] == texture.GetID()) continue;
+        texture.Bind();
+        if (slot < RENDER_QUEUE_TEXTURE_UNITS) this->boundTextures[slot] = texture.GetID();
+        this->stats.textureBinds++;
+    }
+}
+
+void RenderQueue::Execute(const Batch& batch) {
+    const DrawItem& item = this->items[batch.item];
+    this->BindState(item);
+
+    if (batch.commandCount > 0) {
+        GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, this->indirectBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+            (const void*)(batch.firstCommand * sizeof(DrawElementsIndirectCommand)), batch.commandCount, 0);
+
+        uint64_t indices = 0;
+        for (size_t i = batch.firstCommand; i < batch.firstCommand + batch.commandCount; i++) {
+            indices += uint64_t(this->commands[i].count) * this->commands[i].instanceCount;
+        }
+        GLCounters::CountDraw(indices / 3, batch.commandCount);
+    } else {
+        // Instanced VAOs leave the draw ID array disabled, the constant value is read instead
+        glVertexAttribI1ui(DRAW_ID_ATTRIBUTE_LOCATION, item.transformSlot);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, 0, item.instanceCount, item.baseVertex);
+        GLCounters::CountDraw(uint64_t(item.indexCount) * item.instanceCount / 3);
+    }
+    this->stats.drawCalls++;
+}
\ No newline at end of file
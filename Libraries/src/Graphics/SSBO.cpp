@@ -1,4 +1,6 @@
 #include "SSBO.h"
+#include "GLCounters.h"
+#include "GLState.h"
 #include "Logger.h"
 
 SSBO::SSBO() : ID(0), bindingPoint(0), size(0), usage(DYNAMIC_DRAW) {}
@@ -29,11 +31,13 @@ void SSBO::Swap(SSBO& other) noexcept {
     std::swap(this->ID, other.ID);
     std::swap(this->bindingPoint, other.bindingPoint);
     std::swap(this->size, other.size);
+    std::swap(this->capacity, other.capacity);
     std::swap(this->usage, other.usage);
 }
 
 bool SSBO::Initialize(size_t size, GLuint bindingPoint, Usage usage) {
     this->size = size;
+    this->capacity = size;
     this->bindingPoint = bindingPoint;
     this->usage = usage;
 
@@ -41,59 +45,61 @@ bool SSBO::Initialize(size_t size, GLuint bindingPoint, Usage usage) {
     GL_CHECK_ERROR();
     if (this->ID == 0) return false;
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
     GL_CHECK_ERROR();
     glBufferData(GL_SHADER_STORAGE_BUFFER, this->size, nullptr, static_cast<GLenum>(usage));
     GL_CHECK_ERROR();
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
+    GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     GL_CHECK_ERROR_M("Failed to initialize SSBO");
 
     return true;
 }
 
 void SSBO::Destroy() {
-    if (this->ID == 0) return
-    glDeleteBuffers(1, &this->ID);
+    if (this->ID == 0) return;
+    GLState::DeleteBuffers(1, &this->ID);
     GL_CHECK_ERROR();
     this->ID = 0;
     this->bindingPoint = 0;
     this->size = 0;
+    this->capacity = 0;
 }
 
 void SSBO::Bind() const {
     if (this->ID == 0) return;
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
 }
 
 void SSBO::BindToPoint() const {
     if (this->ID == 0) return;
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
+    GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
     GL_CHECK_ERROR_M("Failed to bind SSBO");
 }
 
 void SSBO::Unbind() const {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 void SSBO::UploadData(const void* data, size_t size, size_t offset) {
     if (this->ID == 0) return;
     ensureCapacity(offset + size);
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
     GL_CHECK_ERROR();
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+    GLCounters::CountUpload(size);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     GL_CHECK_ERROR_M("Error uploading data to SSBO");
 }
 
 void SSBO::DownloadData(void* data, size_t size, size_t offset) const {
     if (this->ID == 0) return;
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
     glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 #ifdef DEBUG
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) LOG_ERROR(error, "Error downloading data from SSBO");
@@ -103,43 +109,38 @@ void SSBO::DownloadData(void* data, size_t size, size_t offset) const {
 
 
 void SSBO::Resize(size_t newSize) {
+    if (newSize > this->capacity) {
+        this->Reallocate(GLBuffer::GrowCapacity(this->capacity, newSize), false);
+    }
     this->size = newSize;
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
-    GL_CHECK_ERROR();
-    glBufferData(GL_SHADER_STORAGE_BUFFER, this->size, nullptr, static_cast<GLenum>(this->usage));
-    GL_CHECK_ERROR();
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    GL_CHECK_ERROR();
 }
 
 void SSBO::ResizePreserveData(size_t newSize) {
-    GLuint oldID = this->ID;
-    size_t oldSize = this->size;
-
+    if (newSize > this->capacity) {
+        this->Reallocate(GLBuffer::GrowCapacity(this->capacity, newSize), true);
+    }
     this->size = newSize;
+}
 
-    glGenBuffers(1, &this->ID);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, this->size, nullptr, static_cast<GLenum>(this->usage));
-    
-    size_t copySize = std::min(oldSize, this->size);
-    glBindBuffer(GL_COPY_READ_BUFFER, oldID);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, this->ID);
-    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, copySize);
-    glBindBuffer(GL_COPY_READ_BUFFER, 0);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-    glDeleteBuffers(1, &oldID);
+void SSBO::Reserve(size_t newCapacity) {
+    if (newCapacity > this->capacity) {
+        this->Reallocate(newCapacity, true);
+    }
+}
 
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+void SSBO::Reallocate(size_t newCapacity, bool preserve) {
+    if (this->ID == 0) return;
+    if (!GLBuffer::Reallocate(this->ID, preserve ? this->size : 0, newCapacity, static_cast<GLenum>(this->usage))) return;
+    this->capacity = newCapacity;
+    GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, this->bindingPoint, this->ID);
+    GL_CHECK_ERROR_M("Failed to reallocate SSBO");
 }
 
 
 
 void* SSBO::MapBuffer(GLenum access) const {
     if (this->ID == 0) return nullptr;
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
     GL_CHECK_ERROR();
     void* ptr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, this->size, access);
     GL_CHECK_ERROR();
@@ -150,7 +151,7 @@ void SSBO::UnmapBuffer() const {
     if (this->ID == 0) return;
     glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     GL_CHECK_ERROR();
 }
 
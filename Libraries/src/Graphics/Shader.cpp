@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "GLState.h"
 #include <cstring>
 
 #define COMPILE_SUCCESS 0
@@ -141,16 +142,16 @@ void Shader::CompileShader() {
 
 void Shader::Bind() const {
 	if (this->ID == 0) return;
-	glUseProgram(this->ID);
+	GLState::UseProgram(this->ID);
 }
 
 void Shader::Unbind() const {
-	glUseProgram(0);
+	GLState::UseProgram(0);
 }
 
 void Shader::Destroy() {
     if (this->ID == 0)  return;
-	glDeleteProgram(this->ID);
+	GLState::DeleteProgram(this->ID);
 	this->ID = 0;
 }
 
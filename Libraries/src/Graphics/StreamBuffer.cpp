@@ -0,0 +1,197 @@
+#include "StreamBuffer.h"
+#include "GLCounters.h"
+#include "GLState.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+StreamBuffer::~StreamBuffer() {
+    this->Destroy();
+}
+
+StreamBuffer::StreamBuffer(StreamBuffer&& other) noexcept {
+    this->Swap(other);
+}
+
+StreamBuffer& StreamBuffer::operator=(StreamBuffer&& other) noexcept {
+    if (this != &other) {
+        this->Destroy();
+        this->Swap(other);
+    }
+    return *this;
+}
+
+void StreamBuffer::Swap(StreamBuffer& other) noexcept {
+    std::swap(this->ID, other.ID);
+    std::swap(this->target, other.target);
+    std::swap(this->alignment, other.alignment);
+    std::swap(this->frameSize, other.frameSize);
+    std::swap(this->mapped, other.mapped);
+    std::swap(this->frame, other.frame);
+    std::swap(this->head, other.head);
+    std::swap(this->retired, other.retired);
+}
+
+bool StreamBuffer::SupportsPersistentMapping() {
+    return GLAD_GL_VERSION_4_4 != 0;
+}
+
+bool StreamBuffer::Initialize(GLenum target, size_t frameSize) {
+    this->Destroy();
+    this->target = target;
+
+    GLint offsetAlignment = 16;
+    if (target == GL_UNIFORM_BUFFER) {
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    } else if (target == GL_SHADER_STORAGE_BUFFER) {
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    }
+    this->alignment = static_cast<GLuint>(std::max(offsetAlignment, 16));
+
+    return this->Allocate(frameSize);
+}
+
+bool StreamBuffer::Allocate(size_t frameSize) {
+    // Deleting would unbind the ranges bound from it earlier in the frame
+    if (this->ID != 0) this->retired.push_back({ this->ID, GetFrames().frame });
+    this->ID = 0;
+    this->mapped = nullptr;
+
+    // Every region has to start on an aligned offset
+    this->frameSize = (frameSize + this->alignment - 1) / this->alignment * this->alignment;
+    const size_t totalSize = this->frameSize * STREAM_BUFFER_FRAMES;
+
+    glGenBuffers(1, &this->ID);
+    if (this->ID == 0) return false;
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, this->ID);
+
+    if (SupportsPersistentMapping()) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+        this->mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags);
+        if (this->mapped == nullptr) LOG_WARNING("Stream buffer could not be mapped persistently, falling back to per write mapping");
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GL_CHECK_ERROR_M("Stream buffer allocation");
+
+    this->head = 0;
+    return true;
+}
+
+void StreamBuffer::DeleteRetired(bool all) {
+    // BeginFrame of that many frames later waited on the fence of the frame it was replaced in
+    const uint64_t frame = GetFrames().frame;
+    std::erase_if(this->retired, [&](Retired& buffer) {
+        if (!all && frame < buffer.frame + STREAM_BUFFER_FRAMES) return false;
+        GLState::DeleteBuffers(1, &buffer.ID);
+        return true;
+    });
+}
+
+void StreamBuffer::Destroy() {
+    this->DeleteRetired(true);
+    if (this->ID != 0) {
+        // Deleting the buffer also unmaps it
+        GLState::DeleteBuffers(1, &this->ID);
+        this->ID = 0;
+    }
+    this->mapped = nullptr;
+    this->frameSize = 0;
+    this->frame = UINT64_MAX;
+    this->head = 0;
+}
+
+size_t StreamBuffer::Write(const void* data, size_t size) {
+    if (this->ID == 0 || size == 0) return STREAM_BUFFER_INVALID_OFFSET;
+
+    const Frames& frames = GetFrames();
+    if (this->frame != frames.frame) {
+        this->frame = frames.frame;
+        this->head = 0;
+        if (!this->retired.empty()) this->DeleteRetired(false);
+    }
+
+    size_t aligned = (this->head + this->alignment - 1) / this->alignment * this->alignment;
+    if (aligned + size > this->frameSize) {
+        LOG_WARNING("Stream buffer region full (", this->frameSize, " bytes), growing");
+        if (!this->Allocate(std::max(this->frameSize * 2, size))) return STREAM_BUFFER_INVALID_OFFSET;
+        aligned = 0;
+    }
+
+    const size_t offset = (this->frame % STREAM_BUFFER_FRAMES) * this->frameSize + aligned;
+    if (this->mapped != nullptr) {
+        std::memcpy(static_cast<char*>(this->mapped) + offset, data, size);
+    } else {
+        // The fences already guarantee the GPU is done with this range
+        GLState::BindBuffer(GL_COPY_WRITE_BUFFER, this->ID);
+        void* ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (ptr != nullptr) {
+            std::memcpy(ptr, data, size);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        GL_CHECK_ERROR_M("Stream buffer write");
+        if (ptr == nullptr) return STREAM_BUFFER_INVALID_OFFSET;
+    }
+
+    this->head = aligned + size;
+    GLCounters::CountUpload(size);
+    return offset;
+}
+
+bool StreamBuffer::Stage(const void* data, size_t size, GLuint dst, size_t dstOffset) {
+    const size_t offset = this->Write(data, size);
+    if (offset == STREAM_BUFFER_INVALID_OFFSET) return false;
+
+    GLState::BindBuffer(GL_COPY_READ_BUFFER, this->ID);
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, dst);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, dstOffset, size);
+    GLState::BindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GL_CHECK_ERROR_M("Stream buffer stage");
+    return true;
+}
+
+void StreamBuffer::BindRange(GLuint bindingPoint, size_t offset, size_t size) const {
+    if (this->ID == 0 || offset == STREAM_BUFFER_INVALID_OFFSET) return;
+    GLState::BindBufferRange(this->target, bindingPoint, this->ID, offset, size);
+    GL_CHECK_ERROR_M("Stream buffer bind range");
+}
+
+void StreamBuffer::BeginFrame() {
+    Frames& frames = GetFrames();
+    GLsync& fence = frames.fences[frames.frame % STREAM_BUFFER_FRAMES];
+    if (fence == nullptr) return;
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    }
+    if (result == GL_WAIT_FAILED) LOG_ERROR(result, "Stream buffer fence wait failed");
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::EndFrame() {
+    Frames& frames = GetFrames();
+    GLsync& fence = frames.fences[frames.frame % STREAM_BUFFER_FRAMES];
+    if (fence != nullptr) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frames.frame++;
+}
+
+void StreamBuffer::DestroyFences() {
+    Frames& frames = GetFrames();
+    for (GLsync& fence : frames.fences) {
+        if (fence != nullptr) glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "GLState.h"
 
 Texture::Texture() 
     : ID(0), slot(0), format(GL_RGBA), pixelType(GL_UNSIGNED_BYTE), Width(0), Height(0), UniformName("")
@@ -169,10 +170,10 @@ void Texture::SetFramebufferTexture(const char* uniformName, GLuint slot, int wi
     this->format = GL_RGBA;
     this->pixelType = GL_UNSIGNED_BYTE;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, FBO);
 
     glGenTextures(1, &this->ID);
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
     glTexImage2D(GL_TEXTURE_2D, 0, this->format, this->Width, this->Height, 0, this->format, this->pixelType, NULL);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -183,14 +184,14 @@ void Texture::SetFramebufferTexture(const char* uniformName, GLuint slot, int wi
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->ID, 0);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Texture::ResizeFramebufferTexture(int width, int height) {
     this->Width = width;
     this->Height = height;
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
     glTexImage2D(GL_TEXTURE_2D, 0, this->format, this->Width, this->Height, 0, this->format, GL_UNSIGNED_BYTE, NULL);
 }
 
@@ -200,16 +201,16 @@ void Texture::texUnit(const Shader &shader) const {
 }
 
 void Texture::Bind() const {
-    glActiveTexture(GL_TEXTURE0 + this->slot);
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLState::ActiveTexture(GL_TEXTURE0 + this->slot);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
 }
 
 void Texture::Unbind() const {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture::Destroy() {
     if (this->ID == 0) return;
-    glDeleteTextures(1, &this->ID);
+    GLState::DeleteTextures(1, &this->ID);
     this->ID = 0;
 }
\ No newline at end of file
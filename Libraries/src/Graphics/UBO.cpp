@@ -1,4 +1,6 @@
 #include "UBO.h"
+#include "GLCounters.h"
+#include "GLState.h"
 #include "Logger.h"
 
 UBO::UBO(size_t size, GLuint bindingPoint, GLenum usage) 
@@ -26,12 +28,14 @@ void UBO::Swap(UBO& other) noexcept {
     std::swap(this->ID, other.ID);
     std::swap(this->bindingPoint, other.bindingPoint);
     std::swap(this->size, other.size);
+    std::swap(this->capacity, other.capacity);
     std::swap(this->usage, other.usage);
 }
 
 
 bool UBO::initialize(size_t size, GLuint bindingPoint, GLenum usage) {
     this->size = size;
+    this->capacity = size;
     this->bindingPoint = bindingPoint;
     this->usage = usage;
 
@@ -39,13 +43,13 @@ bool UBO::initialize(size_t size, GLuint bindingPoint, GLenum usage) {
     GL_CHECK_ERROR_M("UBO gen");
     if (this->ID == 0) return false;
 
-    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->ID);
     GL_CHECK_ERROR_M("UBO bind");
     glBufferData(GL_UNIFORM_BUFFER, this->size, nullptr, this->usage);
     GL_CHECK_ERROR_M("UBO buffer data");
-    glBindBufferBase(GL_UNIFORM_BUFFER, this->bindingPoint, this->ID);
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, this->bindingPoint, this->ID);
     GL_CHECK_ERROR_M("UBO bind base");
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
     GL_CHECK_ERROR_M("UBO unbind");
 
     return true;
@@ -53,48 +57,72 @@ bool UBO::initialize(size_t size, GLuint bindingPoint, GLenum usage) {
 
 void UBO::Destroy() {
     if (this->ID == 0) return;
-    glDeleteBuffers(1, &this->ID);
+    GLState::DeleteBuffers(1, &this->ID);
     GL_CHECK_ERROR_M("UBO delete");
     this->ID = 0;
     this->bindingPoint = 0;
     this->size = 0;
+    this->capacity = 0;
 }
 
 void UBO::Bind() const {
     if (this->ID == 0) return;
-    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->ID);
 }
 
 void UBO::BindToBindingPoint() const {
     if (this->ID == 0) return;
-    glBindBufferBase(GL_UNIFORM_BUFFER, this->bindingPoint, this->ID);
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, this->bindingPoint, this->ID);
     GL_CHECK_ERROR_M("UBO bind to point");
 }
 
 void UBO::Unbind() const {
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
-void UBO::uploadData(const void* data, size_t size, size_t offset) const {
+void UBO::uploadData(const void* data, size_t size, size_t offset) {
     if (this->ID == 0) return;
-    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    if (offset + size > this->size) this->Resize(offset + size);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->ID);
     GL_CHECK_ERROR_M("UBO upload bind");
     glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    GLCounters::CountUpload(size);
     GL_CHECK_ERROR_M("UBO upload subdata");
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
     GL_CHECK_ERROR_M("UBO upload unbind");
 }
 
+void UBO::Resize(size_t newSize) {
+    if (newSize > this->capacity) {
+        this->Reallocate(GLBuffer::GrowCapacity(this->capacity, newSize));
+    }
+    this->size = newSize;
+}
+
+void UBO::Reserve(size_t newCapacity) {
+    if (newCapacity > this->capacity) {
+        this->Reallocate(newCapacity);
+    }
+}
+
+void UBO::Reallocate(size_t newCapacity) {
+    if (this->ID == 0) return;
+    if (!GLBuffer::Reallocate(this->ID, this->size, newCapacity, this->usage)) return;
+    this->capacity = newCapacity;
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, this->bindingPoint, this->ID);
+    GL_CHECK_ERROR_M("UBO reallocate");
+}
+
 
 void* UBO::mapBuffer(GLenum access) const {
     if (this->ID == 0) return nullptr;
-    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->ID);
     return glMapBufferRange(GL_UNIFORM_BUFFER, 0, this->size, access);
 }
 
 void UBO::unmapBuffer() const {
     if (this->ID == 0) return;
     glUnmapBuffer(GL_UNIFORM_BUFFER);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
@@ -1,4 +1,5 @@
 #include "VAO.h"
+#include "GLState.h"
 #include "Logger.h"
 
 
@@ -31,16 +32,16 @@ void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type,
 }
 
 void VAO::Bind() const {
-    glBindVertexArray(this->ID);
+    GLState::BindVertexArray(this->ID);
 }
 
 void VAO::Unbind() const {
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
 void VAO::Destroy() {
     if (this->ID == 0) return;
-    glDeleteVertexArrays(1, &this->ID);
+    GLState::DeleteVertexArrays(1, &this->ID);
     GL_CHECK_ERROR_M("VAO delete");
     this->ID = 0;
 }
\ No newline at end of file
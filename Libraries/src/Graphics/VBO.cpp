@@ -1,4 +1,5 @@
 #include "VBO.h"
+#include "GLState.h"
 #include "Logger.h"
 
 
@@ -24,28 +25,48 @@ VBO::~VBO() {
 
 void VBO::Swap(VBO& other) noexcept {
     std::swap(this->ID, other.ID);
+    std::swap(this->size, other.size);
+    std::swap(this->capacity, other.capacity);
+    std::swap(this->usage, other.usage);
 }
 
 void VBO::Initialize(std::vector<GLfloat>& vertices) {
     glGenBuffers(1, &this->ID);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->ID);
     GL_CHECK_ERROR();
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
     GL_CHECK_ERROR();
+    this->size = this->capacity = vertices.size() * sizeof(GLfloat);
+    this->usage = GL_STATIC_DRAW;
 }
 
 void VBO::Bind() const {
-    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->ID);
 }
 
 void VBO::Unbind() const {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void VBO::Destroy() {
     if (this->ID == 0) return;
-    glDeleteBuffers(1, &this->ID);
+    GLState::DeleteBuffers(1, &this->ID);
     GL_CHECK_ERROR();
     this->ID = 0;
+    this->size = 0;
+    this->capacity = 0;
+}
+
+void VBO::Resize(size_t newSize) {
+    if (newSize > this->capacity) {
+        this->Reserve(GLBuffer::GrowCapacity(this->capacity, newSize));
+    }
+    this->size = newSize;
+}
+
+void VBO::Reserve(size_t newCapacity) {
+    if (newCapacity <= this->capacity) return;
+    if (!GLBuffer::Reallocate(this->ID, this->size, newCapacity, this->usage)) return;
+    this->capacity = newCapacity;
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "VBOInstanced.h"
+#include "GLCounters.h"
+#include "GLState.h"
 
 #include "Logger.h"
 
@@ -27,10 +29,12 @@ void VBOInstanced::Swap(VBOInstanced& other) noexcept {
 void VBOInstanced::Initialize(std::vector<glm::mat4>& mat4) {
     glGenBuffers(1, &this->ID);
     GL_CHECK_ERROR();
-    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->ID);
     GL_CHECK_ERROR();
     glBufferData(GL_ARRAY_BUFFER, mat4.size() * sizeof(glm::mat4), mat4.data(), GL_STATIC_DRAW);
     GL_CHECK_ERROR();
+    this->size = this->capacity = mat4.size() * sizeof(glm::mat4);
+    this->usage = GL_STATIC_DRAW;
 }
 
 void VBOInstanced::UploadData(const void* data, GLsizeiptr size) const {
@@ -40,6 +44,7 @@ void VBOInstanced::UploadData(const void* data, GLsizeiptr size) const {
 void VBOInstanced::UploadData(const void* data, GLsizeiptr size, size_t offset) const {
     this->Bind();
     glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    GLCounters::CountUpload(size);
     GL_CHECK_ERROR();
     this->Unbind();
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "VertexPool.h"
+#include "GLState.h"
+
+#include "Logger.h"
+#include "ObjectTransforms.h"
+
+#include <algorithm>
+
+VertexPool::VertexPool(const std::vector<GLuint>& sizeAttrib, std::shared_ptr<IndexBuffer> indices)
+        : sizeAttrib(sizeAttrib), indices(std::move(indices)) {
+    for (GLuint size : this->sizeAttrib) {
+        this->floatsPerVertex += size;
+    }
+}
+
+VertexPool::~VertexPool() {
+    this->arena.Destroy();
+    this->vao.Destroy();
+}
+
+std::shared_ptr<VertexPool> VertexPool::Acquire(const std::vector<GLuint>& sizeAttrib, const std::shared_ptr<IndexBuffer>& indices) {
+    auto& pools = GetPools();
+    std::erase_if(pools, [](const std::weak_ptr<VertexPool>& pool) { return pool.expired(); });
+
+    for (const auto& weak : pools) {
+        std::shared_ptr<VertexPool> pool = weak.lock();
+        if (pool && pool->indices == indices && pool->sizeAttrib == sizeAttrib) return pool;
+    }
+
+    std::shared_ptr<VertexPool> pool = std::make_shared<VertexPool>(sizeAttrib, indices);
+    pools.push_back(pool);
+    return pool;
+}
+
+bool VertexPool::Allocate(const std::vector<GLfloat>& vertices, VertexRange& range) {
+    if (this->floatsPerVertex == 0) return false;
+    const GLsizei count = static_cast<GLsizei>(vertices.size() / this->floatsPerVertex);
+    if (count == 0) return false;
+
+    const size_t stride = this->GetStride();
+    if (this->arena.GetID() == 0) {
+        this->arena.Initialize(VERTEX_POOL_INITIAL_VERTICES * stride, stride, GL_STATIC_DRAW);
+    }
+
+    BufferRange bytes;
+    if (!this->arena.Allocate(count * stride, bytes)) return false;
+    this->arena.Upload(bytes, vertices.data(), count * stride);
+    range = { static_cast<GLint>(bytes.offset / stride), count };
+
+    // The arena got a new buffer when it grew
+    if (this->arena.GetID() != this->linkedBuffer) {
+        this->LinkAttributes();
+    }
+    return true;
+}
+
+void VertexPool::Free(const VertexRange& range) {
+    if (range.count == 0) return;
+    const size_t stride = this->GetStride();
+    BufferRange bytes = { range.baseVertex * stride, range.count * stride };
+    this->arena.Free(bytes);
+}
+
+void VertexPool::LinkAttributes() {
+    this->vao.Initialize();
+    this->vao.Bind();
+    this->indices->ebo.Bind();
+
+    const GLsizei stride = this->GetStride();
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->arena.GetID());
+    size_t offset = 0;
+    for (GLuint i = 0; i < this->sizeAttrib.size(); i++) {
+        glVertexAttribPointer(i, this->sizeAttrib[i], GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(GLfloat)));
+        glEnableVertexAttribArray(i);
+        offset += this->sizeAttrib[i];
+    }
+    ObjectTransforms::LinkDrawID();
+
+    this->vao.Unbind();
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_ERROR_M("Vertex pool link");
+    this->linkedBuffer = this->arena.GetID();
+}
\ No newline at end of file
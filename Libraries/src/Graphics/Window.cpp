@@ -1,4 +1,5 @@
 #include "Window.h"
+#include "GLState.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -97,7 +98,7 @@ int Window::Init() {
     glfwSwapInterval(this->parameters.vsync ? 1 : 0);
     GL_CHECK_ERROR_M("glfwSwapInterval");
 
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
     GL_CHECK_ERROR_M("glEnable");
 
 
@@ -240,6 +241,9 @@ void Window::HandleInput() {
     if (this->inputManager->IsKeyJustPressed(KeyButton::F11)) {
         this->ToggleBorderless();
     }
+    if (this->inputManager->IsKeyJustPressed(KeyButton::F9)) {
+        TraceCapture::Toggle();
+    }
 
 #ifdef DEBUG
     if (this->inputManager->IsKeyJustPressed(KeyButton::F12)) {
@@ -445,7 +449,7 @@ void Window::PostWindowStateChange() const {
     glfwSwapInterval(this->parameters.vsync ? 1 : 0);
     GL_CHECK_ERROR_M("glfwSwapInterval");
 
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
 
     glClearColor(
         this->parameters.clearColor.r,
@@ -2,6 +2,8 @@
 
 #include "utilities.h"
 
+#include <algorithm>
+
 Grid::Grid() : size_x(1.0f), size_z(1.0f), resolution_x(3), resolution_z(3) {
     this->GeneratePoints();
 }
@@ -14,7 +16,8 @@ Grid::Grid(float size_x, float size_z, int resolution_x, int resolution_z) : siz
     this->GeneratePoints();
 }
 
-Grid::Grid(const Grid& other) : size_x(other.size_x), size_z(other.size_z), resolution_x(other.resolution_x), resolution_z(other.resolution_z), points(other.points), triangles(other.triangles) { }
+// The mesh is not copied, it owns GL objects: the copy builds its own with GenerateMesh
+Grid::Grid(const Grid& other) : size_x(other.size_x), size_z(other.size_z), resolution_x(other.resolution_x), resolution_z(other.resolution_z), lod(other.lod), stitch(other.stitch), points(other.points), triangles(other.triangles), packedVertices(other.packedVertices), heightfield(other.heightfield) { }
 
 Grid::~Grid() {
     this->Destroy();
@@ -23,7 +26,11 @@ Grid::~Grid() {
 void Grid::Destroy() {
     this->points.clear();
     this->triangles.clear();
+    this->packedVertices.clear();
+    this->heightfield.Clear();
+#ifndef HEADLESS
     this->mesh.Destroy();
+#endif
 }
 
 void Grid::init(float size_x, float size_z, int resolution_x, int resolution_z) {
@@ -32,9 +39,11 @@ void Grid::init(float size_x, float size_z, int resolution_x, int resolution_z)
     this->resolution_x = resolution_x;
     this->resolution_z = resolution_z;
 
+    this->triangles.clear();
+
     this->GeneratePoints();
-    this->GenerateTriangles();
     this->GenerateNormals();
+    this->heightfield.Build(this->points, this->resolution_x, this->resolution_z, this->size_x, this->size_z);
 }
 
 void Grid::GeneratePoints() {
@@ -85,21 +94,99 @@ void Grid::GenerateTriangles() {
     }
 }
 
+std::vector<std::array<unsigned int, 3>> Grid::GetTriangles() {
+    if (this->triangles.empty()) {
+        this->GenerateTriangles();
+    }
+    return this->triangles;
+}
+
+unsigned int Grid::GetTriangleCount() const {
+    // Coarser LODs skip vertices and stitched edges drop the triangles that collapse
+    unsigned int count = 0;
+    Grid::ForEachTriangle(this->resolution_x, this->resolution_z, this->lod, this->stitch, [&count](unsigned int, unsigned int, unsigned int) {
+        count++;
+    });
+    return count;
+}
+
+std::vector<unsigned int> Grid::GenerateIndices(unsigned int resolution_x, unsigned int resolution_z, uint8_t lod, uint8_t stitch) {
+    std::vector<unsigned int> indices;
+    if (resolution_x < 2 || resolution_z < 2) return indices;
+
+    const unsigned int step = 1u << lod;
+    const unsigned int cellsX = (resolution_x - 1 + step - 1) / step;
+    const unsigned int cellsZ = (resolution_z - 1 + step - 1) / step;
+    indices.reserve(cellsX * cellsZ * 6);
+
+    Grid::ForEachTriangle(resolution_x, resolution_z, lod, stitch, [&indices](unsigned int a, unsigned int b, unsigned int c) {
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    });
+    return indices;
+}
+
+void Grid::ForEachTriangle(unsigned int resolution_x, unsigned int resolution_z, uint8_t lod, uint8_t stitch, const std::function<void(unsigned int, unsigned int, unsigned int)>& func) {
+    if (resolution_x < 2 || resolution_z < 2) return;
+
+    const unsigned int step = 1u << lod;
+    const unsigned int lastX = resolution_x - 1;
+    const unsigned int lastZ = resolution_z - 1;
+
+    // On a stitched edge, odd vertices of this LOD collapse onto the even ones of the coarser neighbour
+    auto snap = [step](unsigned int v, unsigned int last) {
+        unsigned int coarse = v - v % (step * 2);
+        return (v == last) ? v : coarse;
+    };
+    auto index = [&](unsigned int i, unsigned int j) -> unsigned int {
+        if (((stitch & STITCH_NEG_X) && i == 0) || ((stitch & STITCH_POS_X) && i == lastX)) j = snap(j, lastZ);
+        if (((stitch & STITCH_NEG_Z) && j == 0) || ((stitch & STITCH_POS_Z) && j == lastZ)) i = snap(i, lastX);
+        return i * resolution_z + j;
+    };
+    auto push = [&func](unsigned int a, unsigned int b, unsigned int c) {
+        if (a == b || b == c || a == c) return;
+        func(a, b, c);
+    };
+
+    for (unsigned int i = 0; i < lastX; i += step) {
+        unsigned int i1 = std::min(i + step, lastX);
+        for (unsigned int j = 0; j < lastZ; j += step) {
+            unsigned int j1 = std::min(j + step, lastZ);
+
+            unsigned int p1 = index(i, j);
+            unsigned int p2 = index(i1, j);
+            unsigned int p3 = index(i, j1);
+            unsigned int p4 = index(i1, j1);
+
+            push(p1, p2, p3);
+            push(p2, p4, p3);
+        }
+    }
+}
+
 void Grid::GenerateNormals() {
 
     for (auto& vec : this->points) {
         vec.Normal = glm::vec3(0.0f);
     }
-    
-    for (const auto& triangle : this->triangles) {
-        glm::vec3 p1 = this->points[triangle[0]].Position;
-        glm::vec3 p2 = this->points[triangle[1]].Position;
-        glm::vec3 p3 = this->points[triangle[2]].Position;
-        glm::vec3 normal = glm::normalize(glm::cross(p2 - p1, p3 - p1));
-
-        this->points[triangle[0]].Normal += normal;
-        this->points[triangle[1]].Normal += normal;
-        this->points[triangle[2]].Normal += normal;
+
+    // Same topology as GenerateTriangles, walked in place so no triangle list is needed
+    for (unsigned int i = 0; i < this->resolution_x - 1; i++) {
+        for (unsigned int j = 0; j < this->resolution_z - 1; j++) {
+            Vertex& v1 = this->points[i * this->resolution_z + j];
+            Vertex& v2 = this->points[(i + 1) * this->resolution_z + j];
+            Vertex& v3 = this->points[i * this->resolution_z + (j + 1)];
+            Vertex& v4 = this->points[(i + 1) * this->resolution_z + (j + 1)];
+
+            glm::vec3 n1 = glm::normalize(glm::cross(v2.Position - v1.Position, v3.Position - v1.Position));
+            glm::vec3 n2 = glm::normalize(glm::cross(v4.Position - v2.Position, v3.Position - v2.Position));
+
+            v1.Normal += n1;
+            v2.Normal += n1 + n2;
+            v3.Normal += n1 + n2;
+            v4.Normal += n2;
+        }
     }
 
     for (auto& vec : this->points) {
@@ -107,47 +194,154 @@ void Grid::GenerateNormals() {
     }
 }
 
+#ifndef HEADLESS
 void Grid::GenerateMesh() {
     
     std::vector<GLfloat> vertices;
-    vertices.reserve(this->points.size() * 3);
-    for (const auto& vec : this->points) {
-        vertices.push_back(vec.Position.x);
-        vertices.push_back(vec.Position.y);
-        vertices.push_back(vec.Position.z);
-
-        vertices.push_back(vec.Normal.x);
-        vertices.push_back(vec.Normal.y);
-        vertices.push_back(vec.Normal.z);
-
-        vertices.push_back(vec.Color.x);
-        vertices.push_back(vec.Color.y);
-        vertices.push_back(vec.Color.z);
+    if (this->packedVertices.size() == this->points.size() * FLOATS_PER_VERTEX) {
+        vertices = std::move(this->packedVertices);
+        this->packedVertices.clear();
+    } else {
+        this->PackVertices(vertices);
     }
 
-    std::vector<GLuint> indices;
-    indices.reserve(this->triangles.size() * 3);
-    for (const auto& triangle : this->triangles) {
-        indices.push_back(triangle[0]);
-        indices.push_back(triangle[1]);
-        indices.push_back(triangle[2]);
-    }
+    IndexBufferKey key = this->GetTopologyKey();
+    std::shared_ptr<IndexBuffer> indexBuffer = IndexBufferCache::Acquire(key, [key]() {
+        return Grid::GenerateIndices(key.resolution_x, key.resolution_z, key.lod, key.stitch);
+    });
 
-    this->mesh.Initialize(vertices, indices, { 3, 3, 3 });
+    this->mesh.Initialize(std::move(vertices), indexBuffer, { 3, 3, 3 });
     this->mesh.SetShader(GET_RESOURCE_PATH("shader/default.vert"), GET_RESOURCE_PATH("shader/default.frag"));
-    this->mesh.UpdateUBO();
+    this->mesh.UpdateTransform();
 }
+#endif
+
+
+void Grid::PackVertices(std::vector<float>& out) const {
+    out.resize(this->points.size() * FLOATS_PER_VERTEX);
+    float* dst = out.data();
+    for (const auto& vec : this->points) {
+        dst[0] = vec.Position.x;
+        dst[1] = vec.Position.y;
+        dst[2] = vec.Position.z;
+
+        dst[3] = vec.Normal.x;
+        dst[4] = vec.Normal.y;
+        dst[5] = vec.Normal.z;
 
+        dst[6] = vec.Color.x;
+        dst[7] = vec.Color.y;
+        dst[8] = vec.Color.z;
+        dst += FLOATS_PER_VERTEX;
+    }
+}
 
 void Grid::TransformPoints(std::function<void(Vertex&, unsigned int)> func) {
     for (unsigned int i = 0; i < points.size(); ++i) {
         func(points[i], i);
     }
+    this->packedVertices.clear();
     GenerateNormals();
+    this->heightfield.Build(this->points, this->resolution_x, this->resolution_z, this->size_x, this->size_z);
 }
 
+void Grid::TransformPointsFused(const std::function<void(Vertex&, unsigned int)>& func, bool packVertices) {
+    const unsigned int rx = this->resolution_x;
+    const unsigned int rz = this->resolution_z;
+    if (rx < 2 || rz < 2 || this->points.size() < rx * rz) return;
 
+    // The window holds the tile rows plus one halo row on each side: window row w is grid row i0 - 1 + w
+    const unsigned int tileRows = std::clamp<unsigned int>(FUSED_TILE_BYTES / (rz * sizeof(Vertex)), 1, rx);
+    std::vector<Vertex> window((tileRows + 2) * rz);
+    // Face normals (n1, n2) of the cell rows touching the tile, cell row c stored at c - (i0 - 1)
+    std::vector<glm::vec3> faces((tileRows + 1) * (rz - 1) * 2);
+
+    if (packVertices) {
+        this->packedVertices.resize(this->points.size() * FLOATS_PER_VERTEX);
+    } else {
+        this->packedVertices.clear();
+    }
+
+    auto evaluate = [&](unsigned int i, unsigned int w) {
+        for (unsigned int j = 0; j < rz; j++) {
+            Vertex vertex = this->points[i * rz + j];
+            func(vertex, i * rz + j);
+            window[w * rz + j] = vertex;
+        }
+    };
+    auto face = [&](unsigned int f, unsigned int j, unsigned int k) -> glm::vec3& {
+        return faces[(f * (rz - 1) + j) * 2 + k];
+    };
+
+    evaluate(0, 1);
+    for (unsigned int i0 = 0; i0 < rx; i0 += tileRows) {
+        const unsigned int i1 = std::min(i0 + tileRows, rx);
+        const unsigned int rows = i1 - i0;
+
+        // Rows i0 (and i0 - 1) are already in the window, i1 is the lower halo
+        for (unsigned int i = i0 + 1; i <= i1 && i < rx; i++) {
+            evaluate(i, i - i0 + 1);
+        }
 
-void Grid::Render(Camera& camera) {
-    this->mesh.Render(camera);
-}
\ No newline at end of file
+        // Same split as GenerateTriangles: t1 = (v1, v2, v3), t2 = (v2, v4, v3)
+        // Cell row i0 - 1 (f = 0) was carried over from the previous tile
+        for (unsigned int f = 1; f <= rows; f++) {
+            unsigned int c = i0 - 1 + f;
+            if (c >= rx - 1) break;
+            const Vertex* a = &window[f * rz];
+            const Vertex* b = &window[(f + 1) * rz];
+            for (unsigned int j = 0; j < rz - 1; j++) {
+                const glm::vec3& p1 = a[j].Position;
+                const glm::vec3& p2 = b[j].Position;
+                const glm::vec3& p3 = a[j + 1].Position;
+                const glm::vec3& p4 = b[j + 1].Position;
+                face(f, j, 0) = glm::normalize(glm::cross(p2 - p1, p3 - p1));
+                face(f, j, 1) = glm::normalize(glm::cross(p4 - p2, p3 - p2));
+            }
+        }
+
+        for (unsigned int i = i0; i < i1; i++) {
+            const unsigned int f = i - i0 + 1;
+            const Vertex* source = &window[f * rz];
+            for (unsigned int j = 0; j < rz; j++) {
+                glm::vec3 normal(0.0f);
+                if (i < rx - 1) {
+                    if (j < rz - 1) normal += face(f, j, 0);
+                    if (j > 0) normal += face(f, j - 1, 0) + face(f, j - 1, 1);
+                }
+                if (i > 0) {
+                    if (j < rz - 1) normal += face(f - 1, j, 0) + face(f - 1, j, 1);
+                    if (j > 0) normal += face(f - 1, j - 1, 1);
+                }
+
+                Vertex& vertex = this->points[i * rz + j];
+                vertex.Position = source[j].Position;
+                vertex.Normal = glm::normalize(normal);
+                vertex.Color = source[j].Color;
+
+                if (packVertices) {
+                    float* dst = &this->packedVertices[(static_cast<size_t>(i) * rz + j) * FLOATS_PER_VERTEX];
+                    dst[0] = vertex.Position.x; dst[1] = vertex.Position.y; dst[2] = vertex.Position.z;
+                    dst[3] = vertex.Normal.x;   dst[4] = vertex.Normal.y;   dst[5] = vertex.Normal.z;
+                    dst[6] = vertex.Color.x;    dst[7] = vertex.Color.y;    dst[8] = vertex.Color.z;
+                }
+            }
+        }
+
+        // Slide: the last tile row becomes the upper halo, the lower halo becomes the next first row
+        if (i1 < rx) {
+            std::copy(window.begin() + rows * rz, window.begin() + (rows + 2) * rz, window.begin());
+            std::copy(faces.begin() + rows * (rz - 1) * 2, faces.begin() + (rows + 1) * (rz - 1) * 2, faces.begin());
+        }
+    }
+
+    this->heightfield.Build(this->points, this->resolution_x, this->resolution_z, this->size_x, this->size_z);
+}
+
+
+
+#ifndef HEADLESS
+void Grid::Submit(RenderQueue& queue, const Camera& camera) {
+    this->mesh.Submit(queue, camera);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "Heightfield.h"
+
+#include "Grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void Heightfield::Build(const std::vector<Vertex>& points, unsigned int resolution_x, unsigned int resolution_z, float size_x, float size_z) {
+    this->Clear();
+    if (resolution_x < 2 || resolution_z < 2 || points.size() < resolution_x * resolution_z) return;
+
+    this->resolution_x = resolution_x;
+    this->resolution_z = resolution_z;
+    this->origin_x = -size_x / 2.0f;
+    this->origin_z = -size_z / 2.0f;
+    this->step_x = size_x / (resolution_x - 1);
+    this->step_z = size_z / (resolution_z - 1);
+
+    this->heights.resize(resolution_x * resolution_z);
+    for (size_t i = 0; i < this->heights.size(); i++) {
+        this->heights[i] = points[i].Position.y;
+    }
+
+    Level cells;
+    cells.width = resolution_x - 1;
+    cells.depth = resolution_z - 1;
+    cells.minMax.resize(cells.width * cells.depth);
+    for (unsigned int i = 0; i < cells.width; i++) {
+        for (unsigned int j = 0; j < cells.depth; j++) {
+            float h1 = this->Height(i, j);
+            float h2 = this->Height(i + 1, j);
+            float h3 = this->Height(i, j + 1);
+            float h4 = this->Height(i + 1, j + 1);
+            cells.minMax[i * cells.depth + j] = glm::vec2(
+                std::min(std::min(h1, h2), std::min(h3, h4)),
+                std::max(std::max(h1, h2), std::max(h3, h4)));
+        }
+    }
+    this->pyramid.push_back(std::move(cells));
+
+    while (this->pyramid.back().width > 1 || this->pyramid.back().depth > 1) {
+        const Level& fine = this->pyramid.back();
+        Level coarse;
+        coarse.width = (fine.width + 1) / 2;
+        coarse.depth = (fine.depth + 1) / 2;
+        coarse.minMax.resize(coarse.width * coarse.depth);
+        for (unsigned int i = 0; i < coarse.width; i++) {
+            for (unsigned int j = 0; j < coarse.depth; j++) {
+                glm::vec2 range(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+                for (unsigned int di = 0; di < 2; di++) {
+                    for (unsigned int dj = 0; dj < 2; dj++) {
+                        unsigned int fi = i * 2 + di;
+                        unsigned int fj = j * 2 + dj;
+                        if (fi >= fine.width || fj >= fine.depth) continue;
+                        const glm::vec2& child = fine.minMax[fi * fine.depth + fj];
+                        range.x = std::min(range.x, child.x);
+                        range.y = std::max(range.y, child.y);
+                    }
+                }
+                coarse.minMax[i * coarse.depth + j] = range;
+            }
+        }
+        this->pyramid.push_back(std::move(coarse));
+    }
+}
+
+void Heightfield::Clear() {
+    this->heights.clear();
+    this->pyramid.clear();
+    this->resolution_x = 0;
+    this->resolution_z = 0;
+}
+
+float Heightfield::HeightAt(float x, float z) const {
+    if (this->heights.empty()) return 0.0f;
+
+    float fx = std::clamp((x - this->origin_x) / this->step_x, 0.0f, static_cast<float>(this->resolution_x - 1));
+    float fz = std::clamp((z - this->origin_z) / this->step_z, 0.0f, static_cast<float>(this->resolution_z - 1));
+    unsigned int i = std::min(static_cast<unsigned int>(fx), this->resolution_x - 2);
+    unsigned int j = std::min(static_cast<unsigned int>(fz), this->resolution_z - 2);
+    float tx = fx - i;
+    float tz = fz - j;
+
+    float h0 = this->Height(i, j) + (this->Height(i + 1, j) - this->Height(i, j)) * tx;
+    float h1 = this->Height(i, j + 1) + (this->Height(i + 1, j + 1) - this->Height(i, j + 1)) * tx;
+    return h0 + (h1 - h0) * tz;
+}
+
+void Heightfield::HeightsAt(const std::vector<glm::vec2>& positions, std::vector<float>& heights) const {
+    heights.resize(positions.size());
+    for (size_t k = 0; k < positions.size(); k++) {
+        heights[k] = this->HeightAt(positions[k].x, positions[k].y);
+    }
+}
+
+glm::vec3 Heightfield::Point(unsigned int i, unsigned int j) const {
+    return glm::vec3(this->origin_x + i * this->step_x, this->Height(i, j), this->origin_z + j * this->step_z);
+}
+
+bool Heightfield::IntersectNode(const glm::vec3& origin, const glm::vec3& invDirection, unsigned int level, unsigned int i, unsigned int j, float maxDistance, float& tEnter) const {
+    const Level& node = this->pyramid[level];
+    const glm::vec2& range = node.minMax[i * node.depth + j];
+
+    unsigned int span = 1u << level;
+    unsigned int ci0 = i * span;
+    unsigned int cj0 = j * span;
+    unsigned int ci1 = std::min(ci0 + span, this->resolution_x - 1);
+    unsigned int cj1 = std::min(cj0 + span, this->resolution_z - 1);
+
+    glm::vec3 boxMin(this->origin_x + ci0 * this->step_x, range.x, this->origin_z + cj0 * this->step_z);
+    glm::vec3 boxMax(this->origin_x + ci1 * this->step_x, range.y, this->origin_z + cj1 * this->step_z);
+
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    for (int axis = 0; axis < 3; axis++) {
+        float t0 = (boxMin[axis] - origin[axis]) * invDirection[axis];
+        float t1 = (boxMax[axis] - origin[axis]) * invDirection[axis];
+        if (std::isnan(t0) || std::isnan(t1)) {
+            // Ray parallel to and lying on a slab plane
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return false;
+            continue;
+        }
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    tEnter = tMin;
+    return true;
+}
+
+bool Heightfield::IntersectCell(const glm::vec3& origin, const glm::vec3& direction, unsigned int i, unsigned int j, float maxDistance, RayHit& hit) const {
+    // Same split as the rendered mesh: (p1, p2, p3) and (p2, p4, p3)
+    const glm::vec3 p1 = this->Point(i, j);
+    const glm::vec3 p2 = this->Point(i + 1, j);
+    const glm::vec3 p3 = this->Point(i, j + 1);
+    const glm::vec3 p4 = this->Point(i + 1, j + 1);
+    const glm::vec3 triangles[2][3] = { { p1, p2, p3 }, { p2, p4, p3 } };
+
+    // Slack on the barycentric tests so rays over a shared edge can't slip between both triangles
+    const float epsilon = 1e-5f;
+
+    bool found = false;
+    for (const auto& triangle : triangles) {
+        glm::vec3 edge1 = triangle[1] - triangle[0];
+        glm::vec3 edge2 = triangle[2] - triangle[0];
+        glm::vec3 p = glm::cross(direction, edge2);
+        float det = glm::dot(edge1, p);
+        if (std::fabs(det) < 1e-12f) continue;
+
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - triangle[0];
+        float u = glm::dot(s, p) * invDet;
+        if (u < -epsilon || u > 1.0f + epsilon) continue;
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = glm::dot(direction, q) * invDet;
+        if (v < -epsilon || u + v > 1.0f + epsilon) continue;
+
+        float t = glm::dot(edge2, q) * invDet;
+        if (t < 0.0f || t > maxDistance) continue;
+
+        glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
+        if (normal.y < 0.0f) normal = -normal;
+
+        maxDistance = t;
+        hit.distance = t;
+        hit.position = origin + direction * t;
+        hit.normal = normal;
+        found = true;
+    }
+    return found;
+}
+
+bool Heightfield::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayHit& hit) const {
+    if (this->pyramid.empty() || glm::dot(direction, direction) == 0.0f) return false;
+
+    const glm::vec3 dir = glm::normalize(direction);
+    const glm::vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+    struct Node { unsigned int level, i, j; };
+    Node stack[4 * 32];
+    int top = 0;
+
+    float tEnter;
+    unsigned int root = static_cast<unsigned int>(this->pyramid.size() - 1);
+    if (!this->IntersectNode(origin, invDir, root, 0, 0, maxDistance, tEnter)) return false;
+    stack[top++] = { root, 0, 0 };
+
+    float best = maxDistance;
+    bool found = false;
+    while (top > 0) {
+        Node node = stack[--top];
+
+        if (node.level == 0) {
+            if (this->IntersectCell(origin, dir, node.i, node.j, best, hit)) {
+                best = hit.distance;
+                found = true;
+            }
+            continue;
+        }
+
+        // Visit the children nearest first so later ones get culled by the best hit
+        const Level& fine = this->pyramid[node.level - 1];
+        Node children[4];
+        float enter[4];
+        int count = 0;
+        for (unsigned int di = 0; di < 2; di++) {
+            for (unsigned int dj = 0; dj < 2; dj++) {
+                unsigned int ci = node.i * 2 + di;
+                unsigned int cj = node.j * 2 + dj;
+                if (ci >= fine.width || cj >= fine.depth) continue;
+                if (!this->IntersectNode(origin, invDir, node.level - 1, ci, cj, best, tEnter)) continue;
+
+                int k = count++;
+                while (k > 0 && enter[k - 1] < tEnter) {
+                    children[k] = children[k - 1];
+                    enter[k] = enter[k - 1];
+                    k--;
+                }
+                children[k] = { node.level - 1, ci, cj };
+                enter[k] = tEnter;
+            }
+        }
+        for (int k = 0; k < count; k++) {
+            stack[top++] = children[k];
+        }
+    }
+    return found;
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "TerrainExporter.h"
+
+#include "Grid.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+    std::ofstream OpenOutput(const std::string& path) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            LOG_ERROR(1, "Failed to open ", path, " for export");
+        }
+        return file;
+    }
+
+    bool CheckGrid(const Grid& grid) {
+        if (grid.GetPoints().size() < static_cast<size_t>(grid.GetResolutionX()) * grid.GetResolutionY()) {
+            LOG_ERROR(1, "Cannot export an ungenerated grid");
+            return false;
+        }
+        return true;
+    }
+
+    // Heights come from the heightfield pyramid root when available, otherwise one scan
+    void HeightRange(const Grid& grid, float& minHeight, float& maxHeight) {
+        const Heightfield& heightfield = grid.GetHeightfield();
+        if (!heightfield.IsEmpty()) {
+            minHeight = heightfield.GetMinHeight();
+            maxHeight = heightfield.GetMaxHeight();
+            return;
+        }
+        minHeight = maxHeight = 0.0f;
+        const std::vector<Vertex>& points = grid.GetPoints();
+        if (points.empty()) return;
+        minHeight = maxHeight = points[0].Position.y;
+        for (const Vertex& vertex : points) {
+            minHeight = std::min(minHeight, vertex.Position.y);
+            maxHeight = std::max(maxHeight, vertex.Position.y);
+        }
+    }
+
+    uint32_t CRC32(uint32_t crc, const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> t {};
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void PutBE32(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void WriteChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> header;
+        PutBE32(header, static_cast<uint32_t>(data.size()));
+        header.insert(header.end(), type, type + 4);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+        uint32_t crc = CRC32(0, reinterpret_cast<const uint8_t*>(type), 4);
+        crc = CRC32(crc, data.data(), data.size());
+        std::vector<uint8_t> footer;
+        PutBE32(footer, crc);
+        file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+    }
+
+    // Zlib stream made of stored deflate blocks, emitted one IDAT chunk per row block
+    class PNGStream
+    {
+    public:
+        explicit PNGStream(std::ofstream& file) : file(file) {
+            this->chunk.push_back(0x78);
+            this->chunk.push_back(0x01);
+        }
+
+        void Write(const uint8_t* data, size_t size, bool last) {
+            for (size_t i = 0; i < size; i++) {
+                this->adlerA = (this->adlerA + data[i]) % 65521;
+                this->adlerB = (this->adlerB + this->adlerA) % 65521;
+            }
+
+            do {
+                size_t length = std::min<size_t>(size, 65535);
+                bool isFinal = last && length == size;
+                this->chunk.push_back(isFinal ? 1 : 0);
+                this->chunk.push_back(static_cast<uint8_t>(length));
+                this->chunk.push_back(static_cast<uint8_t>(length >> 8));
+                this->chunk.push_back(static_cast<uint8_t>(~length));
+                this->chunk.push_back(static_cast<uint8_t>(~length >> 8));
+                this->chunk.insert(this->chunk.end(), data, data + length);
+                data += length;
+                size -= length;
+            } while (size > 0);
+
+            if (last) {
+                PutBE32(this->chunk, (this->adlerB << 16) | this->adlerA);
+            }
+            WriteChunk(this->file, "IDAT", this->chunk);
+            this->chunk.clear();
+        }
+
+    private:
+        std::ofstream& file;
+        std::vector<uint8_t> chunk;
+        uint32_t adlerA = 1;
+        uint32_t adlerB = 0;
+    };
+}
+
+uint16_t TerrainExporter::Quantize(float height, float minHeight, float maxHeight) {
+    if (maxHeight <= minHeight) return 0;
+    float normalized = (height - minHeight) / (maxHeight - minHeight);
+    return static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+}
+
+bool TerrainExporter::ExportRAW32(const Grid& grid, const std::string& path) {
+    if (!CheckGrid(grid)) return false;
+    std::ofstream file = OpenOutput(path);
+    if (!file) return false;
+
+    const std::vector<Vertex>& points = grid.GetPoints();
+    const size_t rowSize = grid.GetResolutionY();
+    std::vector<float> block(rowSize * EXPORT_ROW_BLOCK);
+
+    for (size_t row = 0; row < grid.GetResolutionX(); row += EXPORT_ROW_BLOCK) {
+        size_t rows = std::min<size_t>(EXPORT_ROW_BLOCK, grid.GetResolutionX() - row);
+        const Vertex* source = points.data() + row * rowSize;
+        for (size_t k = 0; k < rows * rowSize; k++) {
+            block[k] = source[k].Position.y;
+        }
+        file.write(reinterpret_cast<const char*>(block.data()), rows * rowSize * sizeof(float));
+    }
+    return static_cast<bool>(file);
+}
+
+bool TerrainExporter::ExportRAW16(const Grid& grid, const std::string& path) {
+    if (!CheckGrid(grid)) return false;
+    std::ofstream file = OpenOutput(path);
+    if (!file) return false;
+
+    float minHeight, maxHeight;
+    HeightRange(grid, minHeight, maxHeight);
+
+    const std::vector<Vertex>& points = grid.GetPoints();
+    const size_t rowSize = grid.GetResolutionY();
+    std::vector<uint16_t> block(rowSize * EXPORT_ROW_BLOCK);
+
+    for (size_t row = 0; row < grid.GetResolutionX(); row += EXPORT_ROW_BLOCK) {
+        size_t rows = std::min<size_t>(EXPORT_ROW_BLOCK, grid.GetResolutionX() - row);
+        const Vertex* source = points.data() + row * rowSize;
+        for (size_t k = 0; k < rows * rowSize; k++) {
+            block[k] = Quantize(source[k].Position.y, minHeight, maxHeight);
+        }
+        file.write(reinterpret_cast<const char*>(block.data()), rows * rowSize * sizeof(uint16_t));
+    }
+    return static_cast<bool>(file);
+}
+
+// stb_image_write only emits 8-bit PNGs from a full in-memory image, so the
+// 16-bit grayscale file is written directly with uncompressed deflate blocks.
+bool TerrainExporter::ExportPNG16(const Grid& grid, const std::string& path) {
+    if (!CheckGrid(grid)) return false;
+    std::ofstream file = OpenOutput(path);
+    if (!file) return false;
+
+    float minHeight, maxHeight;
+    HeightRange(grid, minHeight, maxHeight);
+
+    const uint32_t width = grid.GetResolutionY();
+    const uint32_t height = grid.GetResolutionX();
+
+    const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> ihdr;
+    PutBE32(ihdr, width);
+    PutBE32(ihdr, height);
+    ihdr.push_back(16); // bit depth
+    ihdr.push_back(0);  // grayscale
+    ihdr.push_back(0);  // deflate
+    ihdr.push_back(0);  // adaptive filtering, only filter 0 used
+    ihdr.push_back(0);  // no interlace
+    WriteChunk(file, "IHDR", ihdr);
+
+    const std::vector<Vertex>& points = grid.GetPoints();
+    const size_t stride = 1 + width * 2;
+    std::vector<uint8_t> block(stride * EXPORT_ROW_BLOCK);
+    PNGStream stream(file);
+
+    for (size_t row = 0; row < height; row += EXPORT_ROW_BLOCK) {
+        size_t rows = std::min<size_t>(EXPORT_ROW_BLOCK, height - row);
+        for (size_t r = 0; r < rows; r++) {
+            uint8_t* out = block.data() + r * stride;
+            const Vertex* source = points.data() + (row + r) * width;
+            *out++ = 0;
+            for (size_t k = 0; k < width; k++) {
+                uint16_t value = Quantize(source[k].Position.y, minHeight, maxHeight);
+                *out++ = static_cast<uint8_t>(value >> 8);
+                *out++ = static_cast<uint8_t>(value);
+            }
+        }
+        stream.Write(block.data(), rows * stride, row + rows == height);
+    }
+
+    WriteChunk(file, "IEND", {});
+    return static_cast<bool>(file);
+}
+
+bool TerrainExporter::ExportMesh(const Grid& grid, const std::string& path) {
+    if (!CheckGrid(grid)) return false;
+    std::ofstream file = OpenOutput(path);
+    if (!file) return false;
+
+    const std::vector<Vertex>& points = grid.GetPoints();
+    IndexBufferKey topology = grid.GetTopologyKey();
+
+    MeshFileHeader header;
+    header.resolution_x = grid.GetResolutionX();
+    header.resolution_z = grid.GetResolutionY();
+    header.vertexCount = static_cast<uint32_t>(points.size());
+    header.indexSize = points.size() <= 65536 ? 2 : 4;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const size_t rowSize = header.resolution_z;
+    std::vector<float> vertices(rowSize * EXPORT_ROW_BLOCK * header.floatsPerVertex);
+    for (size_t row = 0; row < header.resolution_x; row += EXPORT_ROW_BLOCK) {
+        size_t count = std::min<size_t>(EXPORT_ROW_BLOCK, header.resolution_x - row) * rowSize;
+        const Vertex* source = points.data() + row * rowSize;
+        float* out = vertices.data();
+        for (size_t k = 0; k < count; k++) {
+            std::memcpy(out, &source[k].Position, sizeof(float) * 3);
+            std::memcpy(out + 3, &source[k].Normal, sizeof(float) * 3);
+            std::memcpy(out + 6, &source[k].Color, sizeof(float) * 3);
+            out += header.floatsPerVertex;
+        }
+        file.write(reinterpret_cast<const char*>(vertices.data()), count * header.floatsPerVertex * sizeof(float));
+    }
+
+    // Indices are produced on the fly and flushed per block; the count is patched afterwards
+    std::vector<uint8_t> indices;
+    indices.reserve(rowSize * EXPORT_ROW_BLOCK * 6 * header.indexSize);
+    uint32_t indexCount = 0;
+    auto flush = [&]() {
+        file.write(reinterpret_cast<const char*>(indices.data()), indices.size());
+        indices.clear();
+    };
+    Grid::ForEachTriangle(header.resolution_x, header.resolution_z, topology.lod, topology.stitch,
+        [&](unsigned int a, unsigned int b, unsigned int c) {
+            for (unsigned int index : { a, b, c }) {
+                if (header.indexSize == 2) {
+                    uint16_t value = static_cast<uint16_t>(index);
+                    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                    indices.insert(indices.end(), bytes, bytes + sizeof(value));
+                } else {
+                    uint32_t value = index;
+                    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                    indices.insert(indices.end(), bytes, bytes + sizeof(value));
+                }
+            }
+            indexCount += 3;
+            if (indices.size() + 3 * header.indexSize > indices.capacity()) flush();
+        });
+    flush();
+
+    header.indexCount = indexCount;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
\ No newline at end of file
@@ -2,6 +2,13 @@
 
 #include "utilities.h"
 
+// Headless builds never upload, so the fused kernel skips packing
+#ifdef HEADLESS
+#define PACK_VERTICES false
+#else
+#define PACK_VERTICES true
+#endif
+
 TerrainGenerator::TerrainGenerator(int seed) : noise(seed) {}
 TerrainGenerator::TerrainGenerator(float sizeX, float sizeZ, int resX, int resZ) : noise() {
     init(sizeX, sizeZ, resX, resZ);
@@ -22,27 +29,43 @@ void TerrainGenerator::init(float sizeX, float sizeZ, int resX, int resZ) {
     grid.init(sizeX, sizeZ, resX, resZ);
 }
 
-void TerrainGenerator::Render(Camera& camera) {
-    grid.Render(camera);
+#ifndef HEADLESS
+void TerrainGenerator::Submit(RenderQueue& queue, const Camera& camera) {
+    grid.Submit(queue, camera);
+}
+#endif
+
+void TerrainGenerator::Transform(const std::function<void(Vertex&, unsigned int)>& func) {
+    if (grid.GetPointCount() >= FUSED_MIN_POINTS) {
+        grid.TransformPointsFused(func, PACK_VERTICES);
+    } else {
+        grid.TransformPoints(func);
+    }
+}
+
+void TerrainGenerator::UploadMesh() {
+#ifndef HEADLESS
+    grid.GenerateMesh();
+#endif
 }
 
 
 void TerrainGenerator::GenerateFlatTerrain() {
-    grid.TransformPoints([this](Vertex& vertex, unsigned int index) {
+    this->Transform([this](Vertex& vertex, unsigned int index) {
         UNREFERENCED_PARAMETER(index);
         vertex.Position.y = 0.0f;
     });
-    grid.GenerateMesh();
+    this->UploadMesh();
 }
 
 void TerrainGenerator::GenerateRandomTerrain(float height) {
-    grid.TransformPoints([this, height](Vertex& vertex, unsigned int index) {
+    this->Transform([this, height](Vertex& vertex, unsigned int index) {
         UNREFERENCED_PARAMETER(index);
-        float r = noise.WhiteNoise(vertex.Position.x, vertex.Position.z);
+        float r = noise.WhiteNoise(vertex.Position.x + origin.x, vertex.Position.z + origin.y);
         vertex.Position.y = r * height;
         vertex.Color = glm::vec3(r, 0.0f, 0.0f);
     });
-    grid.GenerateMesh();
+    this->UploadMesh();
 }
 
 
@@ -55,14 +78,14 @@ void TerrainGenerator::GenerateRandomTerrain(float height) {
 // }
 
 void TerrainGenerator::GenerateFractalTerrain(float scale, float height, int octaves, float persistence, float lacunarity) {
-    grid.TransformPoints([this, scale, height, octaves, persistence, lacunarity](Vertex& vertex, unsigned int index) {
+    this->Transform([this, scale, height, octaves, persistence, lacunarity](Vertex& vertex, unsigned int index) {
         UNREFERENCED_PARAMETER(index);
-        float r = noise.FractalNoise(vertex.Position.x, vertex.Position.z, scale, octaves, persistence, lacunarity);
+        float r = noise.FractalNoise(vertex.Position.x + origin.x, vertex.Position.z + origin.y, scale, octaves, persistence, lacunarity);
         vertex.Position.y = r * height;
         vertex.Color = glm::vec3(
             r, 0.0f, -r);
     });
-    grid.GenerateMesh();
+    this->UploadMesh();
 }
 
 // void TerrainGenerator::GenerateCrater(float depth, float radius, glm::vec3 center) {
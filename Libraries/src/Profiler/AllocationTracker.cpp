@@ -0,0 +1,377 @@
+#include "AllocationTracker.h"
+
+#include "Logger.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define ALLOC_TRACKER_HAS_STACKS 1
+#endif
+
+namespace
+{
+    // Owning thread only, trivially initialized so touching them never allocates
+    thread_local ProfileZoneID zoneStack[ALLOC_TRACKER_ZONE_DEPTH];
+    thread_local uint32_t zoneDepth = 0;
+    thread_local int32_t threadSlot = -1;
+    thread_local bool inHook = false;
+}
+
+AllocationTracker::Counters& AllocationTracker::GetThreadCounters() noexcept {
+    Data& data = GetData();
+    if (threadSlot < 0) {
+        // Threads past the limit share the last slot, the counters are atomic
+        const uint32_t slot = data.threadCount.fetch_add(1, std::memory_order_relaxed);
+        threadSlot = static_cast<int32_t>(std::min<uint32_t>(slot, ALLOC_TRACKER_MAX_THREADS - 1));
+    }
+    return data.threads[threadSlot];
+}
+
+void AllocationTracker::RecordAllocation(size_t bytes) noexcept {
+    if (inHook) return;
+    inHook = true;
+
+    Data& data = GetData();
+    Counters& counters = GetThreadCounters();
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    const size_t zone = zoneDepth > 0 && zoneDepth <= ALLOC_TRACKER_ZONE_DEPTH ? zoneStack[zoneDepth - 1] : ALLOC_TRACKER_NO_ZONE;
+    assert(zone <= ALLOC_TRACKER_NO_ZONE);
+    data.zoneAllocations[zone].fetch_add(1, std::memory_order_relaxed);
+    data.zoneBytes[zone].fetch_add(bytes, std::memory_order_relaxed);
+
+    if (data.capturing.load(std::memory_order_relaxed)) RecordSite(bytes);
+    inHook = false;
+}
+
+void AllocationTracker::RecordFree() noexcept {
+    if (inHook) return;
+    GetThreadCounters().frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationTracker::EnterZone(ProfileZoneID id) noexcept {
+    // Invalid ids are still pushed so LeaveZone stays paired, their allocations go to no zone
+    if (zoneDepth < ALLOC_TRACKER_ZONE_DEPTH) zoneStack[zoneDepth] = id < PROFILE_ZONE_MAX_IDS ? id : ALLOC_TRACKER_NO_ZONE;
+    zoneDepth++;
+}
+
+void AllocationTracker::LeaveZone() noexcept {
+    if (zoneDepth > 0) zoneDepth--;
+}
+
+void AllocationTracker::RecordSite(size_t bytes) noexcept {
+#ifdef ALLOC_TRACKER_HAS_STACKS
+    void* stack[ALLOC_TRACKER_STACK_DEPTH + ALLOC_TRACKER_SKIP_FRAMES];
+    const int captured = backtrace(stack, ALLOC_TRACKER_STACK_DEPTH + ALLOC_TRACKER_SKIP_FRAMES);
+    // Drop RecordSite and RecordAllocation
+    const int depth = std::max(captured - ALLOC_TRACKER_SKIP_FRAMES, 0);
+    void** frames = stack + (captured - depth);
+
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < depth; i++) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+
+    Data& data = GetData();
+    while (data.sitesLock.test_and_set(std::memory_order_acquire)) {}
+    Site* site = nullptr;
+    for (uint32_t i = 0; i < data.siteCount; i++) {
+        if (data.sites[i].hash == hash && data.sites[i].depth == depth
+            && std::equal(frames, frames + depth, data.sites[i].stack)) {
+            site = &data.sites[i];
+            break;
+        }
+    }
+    if (site == nullptr && data.siteCount < ALLOC_TRACKER_MAX_SITES) {
+        site = &data.sites[data.siteCount++];
+        std::copy(frames, frames + depth, site->stack);
+        site->depth = depth;
+        site->hash = hash;
+        site->allocations = 0;
+        site->bytes = 0;
+    }
+    if (site != nullptr) {
+        site->allocations++;
+        site->bytes += bytes;
+    } else {
+        data.droppedSites++;
+    }
+    data.sitesLock.clear(std::memory_order_release);
+#else
+    (void)bytes;
+#endif
+}
+
+size_t AllocationTracker::GetThreadCount() {
+    return std::min<uint32_t>(GetData().threadCount.load(std::memory_order_relaxed), ALLOC_TRACKER_MAX_THREADS);
+}
+
+AllocationCounters AllocationTracker::GetThreadTotal(size_t thread) {
+    const Counters& counters = GetData().threads[thread];
+    return { counters.allocations.load(std::memory_order_relaxed), counters.bytes.load(std::memory_order_relaxed),
+             counters.frees.load(std::memory_order_relaxed) };
+}
+
+void AllocationTracker::StartReport(uint32_t frames, int64_t budget) {
+    Data& data = GetData();
+    if (!IsEnabled()) {
+        data.reportDone = true;
+        if (budget >= 0) {
+            data.overBudget = true;
+            LOG_ERROR(1, "Allocation budget requested but the build has no allocation tracking (make TRACK_ALLOCATIONS=1)");
+        } else {
+            LOG_WARNING("Allocation report requested but the build has no allocation tracking (make TRACK_ALLOCATIONS=1)");
+        }
+        return;
+    }
+    data.reportFrames = data.reportFramesLeft = std::max<uint32_t>(frames, 1);
+    data.budget = budget;
+    data.reportDone = false;
+    data.overBudget = false;
+    data.reportTotal = AllocationCounters();
+    data.reportWorstFrame = 0;
+}
+
+void AllocationTracker::BeginFrame() {
+    Data& data = GetData();
+
+    AllocationCounters total;
+    for (size_t i = 0; i < GetThreadCount(); i++) {
+        const AllocationCounters thread = GetThreadTotal(i);
+        total.allocations += thread.allocations;
+        total.bytes += thread.bytes;
+        total.frees += thread.frees;
+    }
+    data.last = { total.allocations - data.total.allocations, total.bytes - data.total.bytes, total.frees - data.total.frees };
+    data.total = total;
+    data.frame++;
+
+    if (data.reportFramesLeft == 0 || data.frame < ALLOC_REPORT_WARMUP_FRAMES) return;
+
+    if (!data.capturing.load(std::memory_order_relaxed)) {
+        // The window starts with the next frame
+        for (size_t zone = 0; zone <= ALLOC_TRACKER_NO_ZONE; zone++) {
+            data.zoneAllocationsBase[zone] = data.zoneAllocations[zone].load(std::memory_order_relaxed);
+            data.zoneBytesBase[zone] = data.zoneBytes[zone].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < ALLOC_TRACKER_MAX_THREADS; i++) {
+            data.threadsBase[i] = GetThreadTotal(i);
+        }
+        data.siteCount = 0;
+        data.droppedSites = 0;
+        data.capturing.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    data.reportTotal.allocations += data.last.allocations;
+    data.reportTotal.bytes += data.last.bytes;
+    data.reportTotal.frees += data.last.frees;
+    if (data.last.allocations > data.reportWorstFrame || data.reportFramesLeft == data.reportFrames) {
+        data.reportWorstFrame = data.last.allocations;
+        data.reportWorstFrameIndex = data.frame - 1;
+    }
+
+    if (--data.reportFramesLeft > 0) return;
+    data.capturing.store(false, std::memory_order_relaxed);
+    // Wait for a thread still inside RecordSite
+    while (data.sitesLock.test_and_set(std::memory_order_acquire)) {}
+    data.sitesLock.clear(std::memory_order_release);
+
+    // Close the zone and thread windows before the report allocates
+    for (size_t zone = 0; zone <= ALLOC_TRACKER_NO_ZONE; zone++) {
+        data.zoneAllocationsBase[zone] = data.zoneAllocations[zone].load(std::memory_order_relaxed) - data.zoneAllocationsBase[zone];
+        data.zoneBytesBase[zone] = data.zoneBytes[zone].load(std::memory_order_relaxed) - data.zoneBytesBase[zone];
+    }
+    for (size_t i = 0; i < ALLOC_TRACKER_MAX_THREADS; i++) {
+        const AllocationCounters thread = GetThreadTotal(i);
+        data.threadsBase[i] = { thread.allocations - data.threadsBase[i].allocations, thread.bytes - data.threadsBase[i].bytes,
+                                thread.frees - data.threadsBase[i].frees };
+    }
+
+    data.overBudget = data.budget >= 0 && data.reportWorstFrame > static_cast<uint64_t>(data.budget);
+    data.reportDone = true;
+    WriteReport();
+}
+
+#ifdef ALLOC_TRACKER_HAS_STACKS
+// "module(mangled+0x1f) [0x...]" with the symbol demangled when possible
+static std::string DescribeFrame(const char* symbol) {
+    std::string line = symbol;
+    const size_t open = line.find('(');
+    const size_t plus = line.find('+', open);
+    if (open == std::string::npos || plus == std::string::npos || plus == open + 1) return line;
+
+    const std::string mangled = line.substr(open + 1, plus - open - 1);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) line.replace(open + 1, plus - open - 1, demangled);
+    std::free(demangled);
+    return line;
+}
+#endif
+
+void AllocationTracker::WriteReport() {
+    Data& data = GetData();
+
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::stringstream ss;
+    ss << GetUserDataPath() << "allocations/allocations_" << std::put_time(std::localtime(&time_t), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    const std::string filename = ss.str();
+    std::filesystem::create_directories(std::filesystem::path(filename).parent_path());
+
+    const double frames = data.reportFrames;
+    if (data.overBudget) {
+        LOG_ERROR(1, "Allocation budget exceeded: worst frame ", data.reportWorstFrame, " allocations, budget ", data.budget);
+    } else {
+        LOG_INFO("Allocations per frame: ", data.reportTotal.allocations / frames, " average, ", data.reportWorstFrame, " worst");
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to open allocation report: ", filename);
+        return;
+    }
+
+    file << "Allocation report, " << data.reportFrames << " frames after " << ALLOC_REPORT_WARMUP_FRAMES << " warmup frames\n";
+    file << "Per frame: " << data.reportTotal.allocations / frames << " allocations, " << data.reportTotal.bytes / frames
+         << " bytes, " << data.reportTotal.frees / frames << " frees\n";
+    file << "Worst frame: " << data.reportWorstFrame << " allocations (frame " << data.reportWorstFrameIndex << ")\n";
+    if (data.budget >= 0) {
+        file << "Budget: " << data.budget << " allocations per frame, " << (data.overBudget ? "EXCEEDED" : "ok") << "\n";
+    }
+
+    file << "\nThreads:\n";
+    for (size_t i = 0; i < GetThreadCount(); i++) {
+        const AllocationCounters& thread = data.threadsBase[i];
+        if (thread.allocations == 0) continue;
+        file << "  thread " << i << ": " << thread.allocations / frames << " allocations, " << thread.bytes / frames << " bytes per frame\n";
+    }
+
+    // Innermost zone only, the allocations of a child are not counted in its parent
+    file << "\nZones (self):\n";
+    for (size_t zone = 0; zone <= ALLOC_TRACKER_NO_ZONE; zone++) {
+        const uint64_t allocations = data.zoneAllocationsBase[zone];
+        if (allocations == 0) continue;
+        const uint64_t bytes = data.zoneBytesBase[zone];
+        const char* name = zone == ALLOC_TRACKER_NO_ZONE ? "(no zone)" : ProfileZones::GetName(static_cast<ProfileZoneID>(zone));
+        file << "  " << name << ": " << allocations / frames << " allocations, " << bytes / frames << " bytes per frame\n";
+    }
+
+    file << "\nCall sites:\n";
+#ifdef ALLOC_TRACKER_HAS_STACKS
+    std::sort(data.sites, data.sites + data.siteCount, [](const Site& a, const Site& b) { return a.allocations > b.allocations; });
+    for (uint32_t i = 0; i < std::min<uint32_t>(data.siteCount, ALLOC_REPORT_TOP_SITES); i++) {
+        const Site& site = data.sites[i];
+        file << "  #" << i << ": " << site.allocations / frames << " allocations, " << site.bytes / frames << " bytes per frame\n";
+        char** symbols = backtrace_symbols(site.stack, site.depth);
+        if (symbols == nullptr) continue;
+        // Start under operator new when the symbols tell where it is
+        std::vector<std::string> callStack;
+        for (int frame = 0; frame < site.depth; frame++) {
+            callStack.push_back(DescribeFrame(symbols[frame]));
+            if (callStack.back().find("operator new") != std::string::npos) callStack.clear();
+        }
+        std::free(symbols);
+        for (const std::string& frame : callStack) {
+            file << "      " << frame << "\n";
+        }
+    }
+    if (data.siteCount > ALLOC_REPORT_TOP_SITES) file << "  " << data.siteCount - ALLOC_REPORT_TOP_SITES << " more sites\n";
+    if (data.droppedSites > 0) file << "  " << data.droppedSites << " allocations from untracked sites (table full)\n";
+#else
+    file << "  Call stacks are not available on this platform\n";
+#endif
+    file.close();
+    LOG_INFO("Allocation report written to ", filename);
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+// Global hooks, every form of operator new and delete goes through these two
+
+static void* TrackedAllocate(size_t size, size_t alignment, bool nothrow) {
+    if (size == 0) size = 1;
+    while (true) {
+        void* ptr = nullptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ptr = std::malloc(size);
+        } else {
+#ifdef _WIN32
+            ptr = _aligned_malloc(size, alignment);
+#else
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        }
+        if (ptr != nullptr) {
+            AllocationTracker::RecordAllocation(size);
+            return ptr;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            if (nothrow) return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+static void TrackedFree(void* ptr, size_t alignment) noexcept {
+    if (ptr == nullptr) return;
+    AllocationTracker::RecordFree();
+#ifdef _WIN32
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        _aligned_free(ptr);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(ptr);
+}
+
+void* operator new(size_t size) { return TrackedAllocate(size, 0, false); }
+void* operator new[](size_t size) { return TrackedAllocate(size, 0, false); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return TrackedAllocate(size, 0, true); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return TrackedAllocate(size, 0, true); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocate(size, static_cast<size_t>(alignment), false); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocate(size, static_cast<size_t>(alignment), false); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return TrackedAllocate(size, static_cast<size_t>(alignment), true); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return TrackedAllocate(size, static_cast<size_t>(alignment), true); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr, 0); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr, 0); }
+void operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr, 0); }
+void operator delete[](void* ptr, size_t) noexcept { TrackedFree(ptr, 0); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr, 0); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr, 0); }
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { TrackedFree(ptr, static_cast<size_t>(alignment)); }
+
+#endif
\ No newline at end of file
@@ -16,6 +16,8 @@ FPSCounter::FPSCounter() :
         nextFrameTime(std::chrono::high_resolution_clock::now()) {
     this->fpsBuffer.Init(this->BufferSize);
     this->elapseTimeBuffer.Init(this->BufferSize);
+    this->frameTimeBuffer.Init(this->PercentileWindow);
+    this->frameTimeBuffer.EnablePercentiles();
     this->initializePlatformTimer();
 }
 
@@ -60,6 +62,7 @@ void FPSCounter::Swap(FPSCounter& other) noexcept {
     std::swap(this->minElapseTimens, other.minElapseTimens);
     std::swap(this->fpsBuffer, other.fpsBuffer);
     std::swap(this->elapseTimeBuffer, other.elapseTimeBuffer);
+    std::swap(this->frameTimeBuffer, other.frameTimeBuffer);
 }
 
 void FPSCounter::Destroy() noexcept {
@@ -119,6 +122,8 @@ void FPSCounter::newFrame(unsigned int maxFPS) {
     double newFps = (totalElapsed.count() > 0) ? 1.0e9 / totalElapsed.count() : 0.0;
     this->fps.store(newFps, std::memory_order_relaxed);
     
+    this->frameTimeBuffer.Push(std::chrono::duration_cast<std::chrono::nanoseconds>(totalElapsed));
+
     // Check for dropped frames
     if (maxFPS > 0 && totalElapsed > this->targetFrameTime * 1.5) {
         this->framesDropped.fetch_add(1, std::memory_order_relaxed);
@@ -0,0 +1,106 @@
+#include "GPUTimers.h"
+
+#include "Logger.h"
+
+void GPUTimers::Initialize() {
+    Data& data = GetData();
+    for (Frame& frame : data.frames) {
+        glGenQueries(GPU_TIMER_MAX_ZONES * 2, frame.queries);
+    }
+    data.results.reserve(GPU_TIMER_MAX_ZONES);
+    data.initialized = true;
+    GL_CHECK_ERROR_M("GPU timer pool");
+}
+
+void GPUTimers::Destroy() {
+    Data& data = GetData();
+    if (!data.initialized) return;
+    for (Frame& frame : data.frames) {
+        glDeleteQueries(GPU_TIMER_MAX_ZONES * 2, frame.queries);
+        frame = Frame();
+    }
+    data.results.clear();
+    data.depth = 0;
+    data.initialized = false;
+}
+
+uint32_t GPUTimers::Begin(const std::string& name) {
+    Data& data = GetData();
+    if (!data.initialized) Initialize();
+
+    Frame& frame = data.frames[data.frame % GPU_TIMER_FRAMES];
+    if (frame.count >= GPU_TIMER_MAX_ZONES) return GPU_TIMER_INVALID_ZONE;
+
+    auto it = data.nameIDs.find(name);
+    if (it == data.nameIDs.end()) {
+        it = data.nameIDs.emplace(name, static_cast<uint16_t>(data.names.size())).first;
+        data.names.push_back(name);
+    }
+
+    const uint32_t zone = frame.count++;
+    frame.zones[zone] = { it->second, data.depth++, false };
+    glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+    return zone;
+}
+
+void GPUTimers::End(uint32_t zone) {
+    if (zone == GPU_TIMER_INVALID_ZONE) return;
+
+    Data& data = GetData();
+    Frame& frame = data.frames[data.frame % GPU_TIMER_FRAMES];
+    if (zone >= frame.count || frame.zones[zone].ended) return;
+
+    glQueryCounter(frame.queries[zone * 2 + 1], GL_TIMESTAMP);
+    frame.zones[zone].ended = true;
+    frame.last = frame.queries[zone * 2 + 1];
+    data.depth--;
+}
+
+void GPUTimers::Resolve(Frame& frame) {
+    Data& data = GetData();
+    if (frame.count == 0) return;
+
+    // Timestamps complete in order, checking the last one covers the frame
+    GLint available = GL_FALSE;
+    if (frame.last != 0) glGetQueryObjectiv(frame.last, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available != GL_TRUE) {
+        data.dropped++;
+        return;
+    }
+
+    for (uint32_t i = 0; i < frame.count; i++) {
+        const Zone& zone = frame.zones[i];
+        if (!zone.ended) continue;
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        data.results.push_back({ zone.name, zone.depth, frame.frame,
+            std::chrono::nanoseconds(start), std::chrono::nanoseconds(end) });
+    }
+}
+
+const std::vector<GPUTimerResult>& GPUTimers::NewFrame() {
+    Data& data = GetData();
+    data.results.clear();
+    if (!data.initialized) return data.results;
+
+    if (data.depth != 0) {
+        LOG_WARNING("GPU zones left open at the end of the frame");
+        data.depth = 0;
+    }
+
+    // Reading the oldest slot back before handing it to the new frame
+    data.frame++;
+    Frame& frame = data.frames[data.frame % GPU_TIMER_FRAMES];
+    Resolve(frame);
+    frame.count = 0;
+    frame.frame = data.frame;
+    frame.last = 0;
+    GL_CHECK_ERROR_M("GPU timer resolve");
+    return data.results;
+}
+
+const std::string& GPUTimers::GetName(uint16_t name) {
+    return GetData().names.at(name);
+}
\ No newline at end of file
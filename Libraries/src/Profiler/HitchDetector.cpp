@@ -0,0 +1,142 @@
+#include "HitchDetector.h"
+
+#include "Logger.h"
+#include "utilities.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+void HitchDetector::Record(FrameRecord& record, std::chrono::nanoseconds frameTime, const HitchCounters& counters) {
+    Data& data = GetData();
+    record.frame = data.frame;
+    record.frameTime = frameTime;
+    record.time = std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(frameTime);
+    record.counters = counters;
+
+    // assign reuses the capacity of the slot, past the first frames nothing is allocated
+    const size_t threads = ProfileZones::GetThreadCount();
+    if (record.threads.size() < threads) record.threads.resize(threads);
+    for (size_t i = 0; i < threads; i++) {
+        const std::vector<ProfileZoneNode>& tree = ProfileZones::GetFrameTree(i);
+        record.threads[i].assign(tree.begin(), tree.end());
+    }
+    record.gpuFrame = GPUTimers::GetFrame();
+    const std::vector<GPUTimerResult>& gpu = GPUTimers::GetResults();
+    record.gpu.assign(gpu.begin(), gpu.end());
+}
+
+void HitchDetector::NewFrame(std::chrono::nanoseconds frameTime, const HitchCounters& counters) {
+    Data& data = GetData();
+    if (data.threshold <= 0.0f) return;
+
+    FrameRecord& record = data.records[data.frame % (HITCH_HISTORY_FRAMES + 1)];
+    Record(record, frameTime, counters);
+
+    if (data.frame % HITCH_MEDIAN_REFRESH == 0) {
+        data.median = data.frameTimes.GetPercentile(50.0);
+    }
+    data.frameTimes.Push(frameTime);
+
+    const bool warm = data.frameTimes.GetSize() >= HITCH_MIN_FRAMES;
+    const bool cooled = data.hitches == 0 || data.frame - data.lastHitch >= HITCH_COOLDOWN_FRAMES;
+    if (warm && cooled && frameTime.count() > data.median.count() * static_cast<double>(data.threshold)) {
+        data.lastHitch = data.frame;
+        data.hitches++;
+        const std::string filename = WriteSnapshot(record);
+        LOG_WARNING("Hitch: frame ", data.frame, " took ", frameTime.count() * 1e-6, "ms (median ",
+            data.median.count() * 1e-6, "ms), snapshot ", filename.empty() ? "failed" : filename);
+    }
+    data.frame++;
+}
+
+static std::string EscapeJSON(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            case '\r': break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+static void WriteZones(std::ofstream& file, const std::vector<ProfileZoneNode>& tree, uint32_t node, int depth, bool& first) {
+    for (uint32_t child = tree[node].firstChild; child != PROFILE_ZONE_NO_NODE; child = tree[child].nextSibling) {
+        const ProfileZoneNode& zone = tree[child];
+        file << (first ? "" : ",") << "\n        {\"name\":\"" << ProfileZones::GetName(zone.id) << "\",\"depth\":" << depth
+             << ",\"calls\":" << zone.calls << ",\"totalMs\":" << zone.total.count() * 1e-6
+             << ",\"selfMs\":" << zone.self.count() * 1e-6 << "}";
+        first = false;
+        WriteZones(file, tree, child, depth + 1, first);
+    }
+}
+
+std::string HitchDetector::WriteSnapshot(const FrameRecord& hitch) {
+    Data& data = GetData();
+
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::stringstream ss;
+    ss << GetUserDataPath() << "hitches/hitch_" << std::put_time(std::localtime(&time_t), "%Y-%m-%d_%H-%M-%S")
+       << "_" << hitch.frame << ".json";
+    const std::string filename = ss.str();
+    std::filesystem::create_directories(std::filesystem::path(filename).parent_path());
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to open hitch snapshot: ", filename);
+        return "";
+    }
+
+    // Oldest frame first, the hitch is the last one
+    const size_t slots = HITCH_HISTORY_FRAMES + 1;
+    const size_t count = std::min<uint64_t>(hitch.frame + 1, slots);
+    std::chrono::system_clock::time_point since = hitch.time;
+
+    file << "{\n  \"hitchFrame\": " << hitch.frame << ",\n  \"frameTimeMs\": " << hitch.frameTime.count() * 1e-6
+         << ",\n  \"medianMs\": " << data.median.count() * 1e-6 << ",\n  \"threshold\": " << data.threshold
+         << ",\n  \"frames\": [";
+    for (size_t i = 0; i < count; i++) {
+        const FrameRecord& record = data.records[(hitch.frame + slots - (count - 1 - i)) % slots];
+        since = std::min(since, record.time);
+
+        file << (i == 0 ? "" : ",") << "\n    {\"frame\":" << record.frame << ",\"frameTimeMs\":" << record.frameTime.count() * 1e-6
+             << ",\"glIssued\":" << record.counters.glIssued << ",\"glSkipped\":" << record.counters.glSkipped
+             << ",\"drawCalls\":" << record.counters.drawCalls << ",\"stateChanges\":" << record.counters.stateChanges
+             << ",\"triangles\":" << record.counters.triangles << ",\"uploadBytes\":" << record.counters.uploadBytes
+             << ",\"programSwitches\":" << record.counters.programSwitches << ",\"textureBinds\":" << record.counters.textureBinds
+             << ",\"allocations\":" << record.counters.allocations << ",\"allocatedBytes\":" << record.counters.allocatedBytes
+             << ",\"cpu\":[";
+        for (size_t thread = 0; thread < record.threads.size(); thread++) {
+            file << (thread == 0 ? "" : ",") << "\n      {\"thread\":" << thread << ",\"zones\":[";
+            bool first = true;
+            if (!record.threads[thread].empty()) WriteZones(file, record.threads[thread], 0, 0, first);
+            file << "]}";
+        }
+        // GPU zones resolved during this frame, "frame" is the one that issued them
+        file << "],\"gpu\":[";
+        for (size_t j = 0; j < record.gpu.size(); j++) {
+            const GPUTimerResult& zone = record.gpu[j];
+            const uint64_t age = record.gpuFrame - std::min(zone.frame, record.gpuFrame);
+            file << (j == 0 ? "" : ",") << "\n      {\"name\":\"" << GPUTimers::GetName(zone.name) << "\",\"depth\":" << zone.depth
+                 << ",\"frame\":" << (record.frame >= age ? record.frame - age : 0)
+                 << ",\"ms\":" << (zone.end - zone.start).count() * 1e-6 << "}";
+        }
+        file << "]}";
+    }
+
+    file << "\n  ],\n  \"log\": [";
+    const std::vector<std::string> lines = Logger::GetLogsSince(since);
+    for (size_t i = 0; i < lines.size(); i++) {
+        file << (i == 0 ? "" : ",") << "\n    \"" << EscapeJSON(lines[i]) << "\"";
+    }
+    file << "\n  ]\n}\n";
+    return filename;
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "ProfileZones.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+#include "TraceCapture.h"
+
+#include <cstring>
+
+ProfileZoneID ProfileZones::Intern(const char* name) {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    for (ProfileZoneID id = 0; id < data.count; id++) {
+        if (std::strcmp(data.names[id], name) == 0) return id;
+    }
+    if (data.count >= PROFILE_ZONE_MAX_IDS) {
+        LOG_WARNING("Too many profile zones, ", name, " is not recorded");
+        return PROFILE_ZONE_INVALID_ID;
+    }
+    data.names[data.count] = name;
+    return data.count++;
+}
+
+ProfileZoneID ProfileZones::Find(const char* name) {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    for (ProfileZoneID id = 0; id < data.count; id++) {
+        if (std::strcmp(data.names[id], name) == 0) return id;
+    }
+    return PROFILE_ZONE_INVALID_ID;
+}
+
+const char* ProfileZones::GetName(ProfileZoneID id) {
+    Data& data = GetData();
+    if (id >= PROFILE_ZONE_MAX_IDS || data.names[id] == nullptr) return "";
+    return data.names[id];
+}
+
+ProfileZones::ThreadState& ProfileZones::GetThreadState() {
+    // Hands the state back when the thread exits, Collect recycles it once drained
+    struct Owner
+    {
+        ThreadState* state = nullptr;
+        ~Owner() {
+            if (this->state != nullptr) this->state->exited.store(true, std::memory_order_release);
+        }
+    };
+    thread_local Owner owner;
+
+    if (owner.state == nullptr) {
+        // Once per thread, a state left by an exited thread is reused before allocating a ring
+        Data& data = GetData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        for (const std::unique_ptr<ThreadState>& state : data.threads) {
+            if (!state->reusable) continue;
+            state->reusable = false;
+            state->exited.store(false, std::memory_order_relaxed);
+            state->depth = 0;
+            state->skipDepth = 0;
+            owner.state = state.get();
+            break;
+        }
+        if (owner.state == nullptr) {
+            data.threads.push_back(std::make_unique<ThreadState>());
+            owner.state = data.threads.back().get();
+            owner.state->tree.emplace_back();
+        }
+        owner.state->threadID = std::this_thread::get_id();
+    }
+    return *owner.state;
+}
+
+void ProfileZones::Begin(ProfileZoneID id) noexcept {
+    if constexpr (AllocationTracker::IsEnabled()) AllocationTracker::EnterZone(id);
+    ThreadState& state = GetThreadState();
+    // Once a zone is dropped its children are too, so begin and end stay paired
+    // A begin also keeps room for its own end and the ends of the open zones
+    if (state.skipDepth > 0 || id == PROFILE_ZONE_INVALID_ID || state.events.GetFreeSpace() < state.depth + 2
+        || !state.events.TryPush({ Now(), id, true })) {
+        state.skipDepth++;
+        GetData().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    state.depth++;
+}
+
+void ProfileZones::End() noexcept {
+    if constexpr (AllocationTracker::IsEnabled()) AllocationTracker::LeaveZone();
+    ThreadState& state = GetThreadState();
+    if (state.skipDepth > 0) {
+        state.skipDepth--;
+        return;
+    }
+    if (state.depth == 0) return;
+    state.depth--;
+    state.events.TryPush({ Now(), PROFILE_ZONE_INVALID_ID, false });
+}
+
+uint32_t ProfileZones::FindOrAddChild(std::vector<ProfileZoneNode>& tree, uint32_t parent, ProfileZoneID id) {
+    for (uint32_t child = tree[parent].firstChild; child != PROFILE_ZONE_NO_NODE; child = tree[child].nextSibling) {
+        if (tree[child].id == id) return child;
+    }
+
+    ProfileZoneNode node;
+    node.id = id;
+    node.parent = parent;
+    node.nextSibling = tree[parent].firstChild;
+    const uint32_t index = static_cast<uint32_t>(tree.size());
+    tree.push_back(node);
+    tree[parent].firstChild = index;
+    return index;
+}
+
+void ProfileZones::Drain(ThreadState& state, uint16_t thread) {
+    // Zones still open from the previous frames start the new tree
+    state.tree.assign(1, ProfileZoneNode());
+    for (size_t i = 0; i < state.open.size(); i++) {
+        const uint32_t parent = i == 0 ? 0 : state.open[i - 1].node;
+        state.open[i].node = FindOrAddChild(state.tree, parent, state.open[i].id);
+    }
+
+    state.events.Drain([&](const Event& event) {
+        if (event.begin) {
+            const uint32_t parent = state.open.empty() ? 0 : state.open.back().node;
+            const uint32_t node = FindOrAddChild(state.tree, parent, event.id);
+            state.open.push_back({ event.id, node, event.time, 0 });
+            return;
+        }
+        if (state.open.empty()) return;
+
+        const OpenZone zone = state.open.back();
+        state.open.pop_back();
+        const int64_t duration = event.time - zone.start;
+        ProfileZoneNode& node = state.tree[zone.node];
+        node.calls++;
+        node.total += std::chrono::nanoseconds(duration);
+        node.self += std::chrono::nanoseconds(duration - zone.childTime);
+        if (!state.open.empty()) state.open.back().childTime += duration;
+        TraceCapture::AddCPUZone(zone.id, thread, zone.start, event.time);
+    });
+}
+
+void ProfileZones::Collect() {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    for (size_t thread = 0; thread < data.threads.size(); thread++) {
+        ThreadState& state = *data.threads[thread];
+        // Read before draining, so every event of an exited thread is in this drain.
+        // A recycled state drains nothing until its next owner, its tree stays empty
+        const bool exited = state.exited.load(std::memory_order_acquire);
+        Drain(state, static_cast<uint16_t>(thread));
+        if (exited) {
+            state.open.clear();
+            state.reusable = true;
+        }
+        for (size_t i = 1; i < state.tree.size(); i++) {
+            const ProfileZoneNode& node = state.tree[i];
+            if (node.calls == 0) continue;
+            ZoneStats& stats = data.stats[node.id];
+            stats.frameTotal += node.total;
+            stats.frameSelf += node.self;
+            stats.seen = true;
+        }
+    }
+
+    // A recursive zone is counted once per level in frameTotal, self stays exact
+    for (ProfileZoneID id = 0; id < data.count; id++) {
+        ZoneStats& stats = data.stats[id];
+        if (!stats.seen) continue;
+        stats.total.Push(stats.frameTotal);
+        stats.self.Push(stats.frameSelf);
+        stats.frameTotal = std::chrono::nanoseconds(0);
+        stats.frameSelf = std::chrono::nanoseconds(0);
+        stats.seen = false;
+    }
+}
+
+size_t ProfileZones::GetThreadCount() {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    return data.threads.size();
+}
+
+const std::vector<ProfileZoneNode>& ProfileZones::GetFrameTree(size_t thread) {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    return data.threads.at(thread)->tree;
+}
+
+std::thread::id ProfileZones::GetThreadID(size_t thread) {
+    Data& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    return data.threads.at(thread)->threadID;
+}
+
+std::chrono::nanoseconds ProfileZones::GetAverageTotalTime(const char* name) {
+    const ProfileZoneID id = Find(name);
+    if (id == PROFILE_ZONE_INVALID_ID) return std::chrono::nanoseconds(0);
+    return GetData().stats[id].total.GetAverage();
+}
+
+std::chrono::nanoseconds ProfileZones::GetAverageSelfTime(const char* name) {
+    const ProfileZoneID id = Find(name);
+    if (id == PROFILE_ZONE_INVALID_ID) return std::chrono::nanoseconds(0);
+    return GetData().stats[id].self.GetAverage();
+}
+
+std::chrono::nanoseconds ProfileZones::GetPercentileTotalTime(const char* name, double p) {
+    const ProfileZoneID id = Find(name);
+    if (id == PROFILE_ZONE_INVALID_ID) return std::chrono::nanoseconds(0);
+    return GetData().stats[id].total.GetPercentile(p);
+}
+
+uint64_t ProfileZones::GetDroppedEvents() {
+    return GetData().dropped.load(std::memory_order_relaxed);
+}
\ No newline at end of file
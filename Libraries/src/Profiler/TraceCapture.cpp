@@ -0,0 +1,139 @@
+#include "TraceCapture.h"
+
+#include <glad/glad.h>
+
+#include "Logger.h"
+#include "utilities.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+void TraceCapture::Start(uint32_t frames) {
+    Data& data = GetData();
+    if (data.capturing) return;
+
+    data.events.clear();
+    data.events.reserve(TRACE_CAPTURE_MAX_EVENTS);
+    data.framesLeft = frames;
+    data.frame = 0;
+    data.dropped = 0;
+    data.gpuFrameBase = GPUTimers::GetFrame();
+    data.startTime = ProfileZones::Now();
+    Calibrate();
+    data.capturing = true;
+    LOG_INFO("Trace capture started", frames > 0 ? std::format(" for {} frames", frames) : std::string());
+}
+
+void TraceCapture::Toggle() {
+    if (IsCapturing()) Stop();
+    else Start();
+}
+
+void TraceCapture::Calibrate() {
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    GetData().gpuOffset = ProfileZones::Now() - gpuTime;
+    GL_CHECK_ERROR_M("Trace GPU clock calibration");
+}
+
+void TraceCapture::Push(const Event& event) {
+    Data& data = GetData();
+    if (data.events.size() >= TRACE_CAPTURE_MAX_EVENTS) {
+        data.dropped++;
+        return;
+    }
+    data.events.push_back(event);
+}
+
+void TraceCapture::AddCPUZone(ProfileZoneID id, uint16_t thread, int64_t start, int64_t end) {
+    if (!IsCapturing()) return;
+    Push({ start, end - start, GetData().frame, id, thread, CPU, 0 });
+}
+
+void TraceCapture::AddGPUZone(const GPUTimerResult& result) {
+    Data& data = GetData();
+    // Results arrive GPU_TIMER_LATENCY frames late, skip those recorded before the start
+    if (!data.capturing || result.frame < data.gpuFrameBase) return;
+    const int64_t start = result.start.count() + data.gpuOffset;
+    const int64_t duration = (result.end - result.start).count();
+    Push({ start, duration, static_cast<uint32_t>(result.frame - data.gpuFrameBase), result.name, TRACE_GPU_THREAD, GPU,
+        static_cast<uint8_t>(result.depth) });
+}
+
+void TraceCapture::AddCounter(ProfileZoneID name, int64_t value) {
+    if (!IsCapturing()) return;
+    Push({ ProfileZones::Now(), value, GetData().frame, name, 0, COUNTER, 0 });
+}
+
+void TraceCapture::NewFrame() {
+    Data& data = GetData();
+    if (!data.capturing) return;
+
+    data.frame++;
+    Push({ ProfileZones::Now(), 0, data.frame, 0, 0, FRAME, 0 });
+    if (data.frame % TRACE_CALIBRATION_FRAMES == 0) Calibrate();
+
+    if (data.framesLeft > 0 && --data.framesLeft == 0) Stop();
+}
+
+std::string TraceCapture::Stop() {
+    Data& data = GetData();
+    if (!data.capturing) return "";
+    data.capturing = false;
+
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::stringstream ss;
+    ss << GetUserDataPath() << "traces/trace_" << std::put_time(std::localtime(&time_t), "%Y-%m-%d_%H-%M-%S") << ".json";
+    const std::string filename = ss.str();
+    std::filesystem::create_directories(std::filesystem::path(filename).parent_path());
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR(1, "Failed to open trace file: ", filename);
+        return "";
+    }
+
+    // Chrome trace timestamps are microseconds
+    auto micros = [](int64_t ns) { return static_cast<double>(ns) * 1e-3; };
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ProceduralGeneration\"}},\n";
+    file << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"GPU\"}}}}", TRACE_GPU_THREAD);
+    for (size_t thread = 0; thread < ProfileZones::GetThreadCount(); thread++) {
+        file << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"CPU {}\"}}}}", thread, thread);
+    }
+
+    for (const Event& event : data.events) {
+        const double ts = micros(event.start - data.startTime);
+        switch (event.source) {
+            case CPU:
+                file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"frame\":{}}}}}",
+                    ProfileZones::GetName(event.name), ts, micros(event.duration), event.thread, event.frame);
+                break;
+            case GPU:
+                file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"frame\":{},\"depth\":{}}}}}",
+                    GPUTimers::GetName(event.name), ts, micros(event.duration), event.thread, event.frame, event.depth);
+                break;
+            case FRAME:
+                file << std::format(",\n{{\"name\":\"Frame {}\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":1,\"tid\":0}}",
+                    event.frame, ts);
+                break;
+            case COUNTER:
+                file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"counter\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"args\":{{\"value\":{}}}}}",
+                    ProfileZones::GetName(event.name), ts, event.duration);
+                break;
+        }
+    }
+    file << "\n]}\n";
+    file.close();
+
+    if (data.dropped > 0) LOG_WARNING("Trace buffer full, ", data.dropped, " events dropped");
+    LOG_INFO("Trace written to ", filename, " (", data.events.size(), " events, ", data.frame, " frames)");
+    data.events.clear();
+    data.events.shrink_to_fit();
+    return filename;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 // Libraries/src/UI/TextRenderer.cpp
 #include "UI/TextRenderer.h"
+#include "GLCounters.h"
+#include "GLState.h"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
@@ -78,11 +80,11 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource) {
 }
 
 Shader::~Shader() {
-    glDeleteProgram(ID);
+    GLState::DeleteProgram(ID);
 }
 
 void Shader::use() {
-    glUseProgram(ID);
+    GLState::UseProgram(ID);
 }
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) {
@@ -102,12 +104,12 @@ void Shader::setInt(const std::string& name, int value) {
 // ============================================
 
 TextRenderer::TextRenderer()
-    : ft(nullptr), VAO(0), VBO(0), screenWidth(800), screenHeight(600) {}
+    : ft(nullptr), VAO(0), screenWidth(800), screenHeight(600) {}
 
 TextRenderer::~TextRenderer() {
     for (auto& [name, fontData] : fonts) {
         for (auto& [c, character] : fontData.characters) {
-            glDeleteTextures(1, &character.textureID);
+            GLState::DeleteTextures(1, &character.textureID);
         }
         FT_Done_Face(fontData.face);
     }
@@ -116,8 +118,8 @@ TextRenderer::~TextRenderer() {
         FT_Done_FreeType(ft);
     }
 
-    if (VAO) glDeleteVertexArrays(1, &VAO);
-    if (VBO) glDeleteBuffers(1, &VBO);
+    if (VAO) GLState::DeleteVertexArrays(1, &VAO);
+    VBO.Destroy();
 }
 
 bool TextRenderer::init(unsigned int width, unsigned int height) {
@@ -144,17 +146,22 @@ bool TextRenderer::init(unsigned int width, unsigned int height) {
 
 void TextRenderer::setupRenderData() {
     glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    // Room for 512 glyphs per frame, the buffer grows past that
+    VBO.Initialize(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4 * 512);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+    linkVertexBuffer();
+    GLState::BindVertexArray(0);
+}
+
+void TextRenderer::linkVertexBuffer() {
+    GLState::BindVertexArray(VAO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, VBO.GetID());
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    linkedVBO = VBO.GetID();
 }
 
 bool TextRenderer::loadFont(const std::string& fontPath, const std::string& fontName,
@@ -197,7 +204,7 @@ Character TextRenderer::loadCharacter(FT_Face face, char c) {
 
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    GLState::BindTexture(GL_TEXTURE_2D, texture);
     glTexImage2D(
         GL_TEXTURE_2D,
         0,
@@ -299,9 +306,9 @@ void TextRenderer::renderText(const std::string& text, float x, float y,
     shader->setVec3("textColor", color);
     shader->setInt("text", 0);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
-    glEnable(GL_BLEND);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindVertexArray(VAO);
+    GLState::Enable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     float cursorX = startX;
@@ -357,17 +364,20 @@ void TextRenderer::renderText(const std::string& text, float x, float y,
             { xpos + w, ypos + h,   1.0f, 0.0f }
         };
 
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+        size_t offset = VBO.Write(vertices, sizeof(vertices));
+        if (offset == STREAM_BUFFER_INVALID_OFFSET) continue;
+        if (VBO.GetID() != linkedVBO) linkVertexBuffer();
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        GLState::BindTexture(GL_TEXTURE_2D, ch.textureID);
+        // Offsets are aligned on 16 bytes, exactly one vertex
+        glDrawArrays(GL_TRIANGLES, static_cast<GLint>(offset / (4 * sizeof(float))), 6);
+        GLCounters::CountDraw(2);
 
         cursorX += (ch.advance >> 6) * scale;
     }
 
-    glBindVertexArray(0);
-    glDisable(GL_BLEND);
+    GLState::BindVertexArray(0);
+    GLState::Disable(GL_BLEND);
 }
 
 float TextRenderer::measureTextWidth(const std::string& text, float scale) {
@@ -645,7 +655,7 @@ void TextRenderer::renderTextAdvanced(const std::string& text, float x, float y,
                        params.maxWidth > 0.0f && params.maxHeight > 0.0f;
 
     if (useScissor) {
-        glEnable(GL_SCISSOR_TEST);
+        GLState::Enable(GL_SCISSOR_TEST);
         // En OpenGL, scissor commence en bas à gauche
         int scissorY = static_cast<int>(screenHeight - (y + params.maxHeight));
         glScissor(
@@ -666,7 +676,7 @@ void TextRenderer::renderTextAdvanced(const std::string& text, float x, float y,
     }
 
     if (useScissor) {
-        glDisable(GL_SCISSOR_TEST);
+        GLState::Disable(GL_SCISSOR_TEST);
     }
 }
 
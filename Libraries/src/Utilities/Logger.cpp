@@ -1,7 +1,11 @@
 #include "Logger.h"
 
 #include "utilities.h"
+#include "LockFreeRing.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -18,16 +22,74 @@
 
 
 std::vector<Logger::LogMessage> Logger::logs;
+uint64_t Logger::logCount = 0;
 std::mutex Logger::logMutex;
 std::unique_ptr<std::ofstream> Logger::logFile;
 bool Logger::isLoggingToFile = false;
-size_t Logger::lastFlushedIndex = 0;
+std::string Logger::logFilename;
+std::string Logger::fileBuffer;
+uint64_t Logger::fileBytes = 0;
+uint64_t Logger::rotateBytes = LOGGER_ROTATE_BYTES;
+int Logger::rotateFiles = LOGGER_ROTATE_FILES;
 #ifdef DEBUG
 LogLevel Logger::lLevelPrinted = LogLevel::L_DEBUGGING;
 #else
 LogLevel Logger::lLevelPrinted = LogLevel::L_INFO;
 #endif
 
+// A queue slot, its strings keep their capacity from one message to the next
+struct LogRecord
+{
+    LogLevel level = L_INFO;
+    int errorCode = 0;
+    std::chrono::time_point<std::chrono::system_clock> time;
+#ifdef DEBUG
+    std::string file;
+    int line = 0;
+#endif
+    std::string message;
+};
+
+struct AsyncLogState
+{
+    MPSCRing<LogRecord, LOGGER_QUEUE_CAPACITY> queue;
+    std::thread writer;
+    std::atomic<bool> running{false};
+    std::atomic<uint32_t> producers{0}; // Submit calls past the running check, the writer outlives them
+    std::atomic<uint32_t> flushers{0};  // Flush calls waiting, the writer skips its interval meanwhile
+    std::mutex stopMutex;               // Held by StopAsync until the last message is drained
+    LogOverflowPolicy policy = LOG_OVERFLOW_BLOCK;
+
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> sampled{0};
+    uint64_t reportedDropped = 0; // Writer thread
+
+    std::mutex wakeMutex;
+    std::condition_variable wake; // Writer waits here between passes
+    std::condition_variable idle; // Flush waits here for the writer to catch up
+
+    // Exit without StopAsync, a joinable thread would terminate the program
+    ~AsyncLogState() {
+        if (!this->writer.joinable()) return;
+        this->running.store(false, std::memory_order_release);
+        this->wake.notify_one();
+        this->writer.join();
+    }
+};
+
+static AsyncLogState& GetAsyncState() {
+    static AsyncLogState state;
+    return state;
+}
+
+// Messages logged by the writer itself are handled in place, it cannot wait on its own queue
+static thread_local bool isWriterThread = false;
+
+static void WakeWriter(AsyncLogState& state) {
+    { std::lock_guard<std::mutex> lock(state.wakeMutex); }
+    state.wake.notify_one();
+}
+
 
 
 void Logger::Initialize(const std::string& sFilename) {
@@ -55,6 +117,7 @@ void Logger::Initialize(const std::string& sFilename) {
     
     // Close existing file
     if (logFile && logFile->is_open()) {
+        WriteFileBuffer();
         *logFile << "\n=== Logger Session Ended: " 
                  << FormatTimestamp(std::chrono::system_clock::now()) << " ===\n";
         logFile->close();
@@ -62,22 +125,25 @@ void Logger::Initialize(const std::string& sFilename) {
     }
     
     // Open new file
-    logFile = std::make_unique<std::ofstream>(filename, std::ios::out | std::ios::app);
-    
-    if (!logFile->is_open()) {
-        std::cerr << "Failed to open log file: " << filename << std::endl;
+    logFilename = filename;
+    if (!OpenLogFile(std::ios::out | std::ios::app)) {
         isLoggingToFile = false;
         return;
     }
+    std::error_code error;
+    fileBytes = std::filesystem::file_size(filename, error);
+    if (error) fileBytes = 0;
+    fileBuffer.reserve(LOGGER_FILE_BUFFER_SIZE);
     
     // Write session header
     auto now = std::chrono::system_clock::now();
-    *logFile << "\n=== Logger Session Started: " 
-             << FormatTimestamp(now) << " ===" << std::endl;
-    *logFile << "Process ID: " << getpid() << std::endl;
-    *logFile << "Working Directory: " << std::filesystem::current_path() << std::endl;
-    *logFile << std::endl;
-    logFile->flush();
+    std::ostringstream header;
+    header << "\n=== Logger Session Started: " 
+           << FormatTimestamp(now) << " ===\n";
+    header << "Process ID: " << getpid() << "\n";
+    header << "Working Directory: " << std::filesystem::current_path() << "\n\n";
+    fileBuffer += header.str();
+    WriteFileBuffer();
     isLoggingToFile = true;
 #ifdef DEBUG
     std::cout << "Logger initialized successfully. File: " << filename << std::endl;
@@ -88,16 +154,22 @@ void Logger::Initialize(const std::string& sFilename) {
 void Logger::Clear() { 
     std::lock_guard<std::mutex> lock(logMutex);
     logs.clear();
-    lastFlushedIndex = 0;
+    logCount = 0;
 }
 
 void Logger::Print() {
     std::lock_guard<std::mutex> lock(logMutex);
-    for (const LogMessage& log : logs) {
-        PrintLog(log);
+    for (uint64_t sequence = GetOldestLog(); sequence < logCount; sequence++) {
+        PrintLog(LogAt(sequence));
     }
 }
 
+void Logger::SetRotation(uint64_t maxBytes, int maxFiles) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    rotateBytes = maxBytes;
+    rotateFiles = std::max(maxFiles, 0);
+}
+
 void Logger::SetMinimumLevel(LogLevel level) {
     std::lock_guard<std::mutex> lock(logMutex);
     lLevelPrinted = level;
@@ -109,14 +181,12 @@ LogLevel Logger::GetMinimumLevel() {
 }
 
 void Logger::FlushToFile() {
+    Flush();
     if (!isLoggingToFile) return;
 
 #ifdef DEBUG
-    size_t sizeLogs = logs.size();
     LOG_DEBUGGING("=== FlushToFile Debug Info ===");
-    LOG_DEBUGGING("Total logs: ", sizeLogs);
-    LOG_DEBUGGING("Last flushed index: ", lastFlushedIndex);
-    LOG_DEBUGGING("Logs to write: ", (sizeLogs - lastFlushedIndex));
+    LOG_DEBUGGING("Logs kept: ", std::min<uint64_t>(logCount, LOGGER_HISTORY_CAPACITY), " of ", logCount);
 #endif
 
     std::lock_guard<std::mutex> lock(logMutex);
@@ -132,40 +202,11 @@ void Logger::FlushToFile() {
     }
     
     // Check if there are new logs to write
-    if (lastFlushedIndex >= logs.size()) {
-        LOG_DEBUGGING("No new logs to write");
+    if (fileBuffer.empty()) {
         return;
     }
     
-    // Write logs that haven't been written yet
-    size_t logsWritten = 0;
-    for (size_t i = lastFlushedIndex; i < logs.size(); ++i) {
-        const LogMessage& log = logs[i];
-
-#ifdef DEBUG
-        if (log.level == L_DEBUGGING) {
-            continue;
-        }
-#endif
-        
-        *logFile << "[" << FormatTimestamp(log.time) << "] ";
-        *logFile << "[" << LevelToString(log.level) << "] ";
-        
-#ifdef DEBUG
-        *logFile << log.file << ":" << log.line << ": ";
-#endif
-        
-        *logFile << log.message;
-        
-        if (log.errorCode != 0) {
-            *logFile << " (Error: " << log.errorCode << ")";
-        }
-        
-        *logFile << std::endl;
-        logsWritten++;
-    }
-    lastFlushedIndex = logs.size();
-    
+    WriteFileBuffer();
     logFile->flush();
 #ifdef DEBUG
     if (logFile->fail()) {
@@ -180,6 +221,101 @@ void Logger::FlushToFile() {
 #endif
 }
 
+Logger::LogMessage& Logger::LogAt(uint64_t sequence) {
+    return logs[sequence % LOGGER_HISTORY_CAPACITY];
+}
+
+uint64_t Logger::GetOldestLog() {
+    return logCount > LOGGER_HISTORY_CAPACITY ? logCount - LOGGER_HISTORY_CAPACITY : 0;
+}
+
+// The stream is unbuffered, lines are gathered in fileBuffer and written in one call
+bool Logger::OpenLogFile(std::ios::openmode mode) {
+    if (!logFile) logFile = std::make_unique<std::ofstream>();
+    logFile->rdbuf()->pubsetbuf(nullptr, 0);
+    logFile->open(logFilename, mode);
+    if (!logFile->is_open()) {
+        std::cerr << "Failed to open log file: " << logFilename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Caller holds logMutex
+void Logger::BufferToFile(const LogMessage& log) {
+    if (!isLoggingToFile) return;
+#ifdef DEBUG
+    if (log.level == L_DEBUGGING) return;
+#endif
+
+    fileBuffer += "[" + FormatTimestamp(log.time) + "] [" + LevelToString(log.level) + "] ";
+#ifdef DEBUG
+    fileBuffer += log.file + ":" + std::to_string(log.line) + ": ";
+#endif
+    fileBuffer += log.message;
+    if (log.errorCode != 0) {
+        fileBuffer += " (Error: " + std::to_string(log.errorCode) + ")";
+    }
+    fileBuffer += '\n';
+
+    // Errors go to disk right away, they are what a crash would leave behind
+    const bool rotate = rotateBytes > 0 && fileBytes + fileBuffer.size() >= rotateBytes;
+    if (fileBuffer.size() >= LOGGER_FILE_BUFFER_SIZE || log.level >= L_ERROR || rotate) {
+        WriteFileBuffer();
+    }
+}
+
+// Caller holds logMutex
+void Logger::WriteFileBuffer() {
+    if (fileBuffer.empty() || !logFile || !logFile->is_open()) return;
+    logFile->write(fileBuffer.data(), static_cast<std::streamsize>(fileBuffer.size()));
+    fileBytes += fileBuffer.size();
+    fileBuffer.clear();
+    if (rotateBytes > 0 && fileBytes >= rotateBytes) RotateFile();
+}
+
+// name.ext becomes name.1.ext, name.1.ext becomes name.2.ext... up to rotateFiles
+void Logger::RotateFile() {
+    logFile->close();
+
+    const std::filesystem::path path(logFilename);
+    auto rotated = [&](int index) {
+        return path.parent_path() / (path.stem().string() + "." + std::to_string(index) + path.extension().string());
+    };
+    std::error_code error;
+    if (rotateFiles > 0) {
+        std::filesystem::remove(rotated(rotateFiles), error);
+        for (int i = rotateFiles - 1; i >= 1; i--) {
+            std::filesystem::rename(rotated(i), rotated(i + 1), error);
+        }
+        std::filesystem::rename(path, rotated(1), error);
+    } else {
+        std::filesystem::remove(path, error);
+    }
+
+    fileBytes = 0;
+    if (!OpenLogFile(std::ios::out | std::ios::trunc)) {
+        isLoggingToFile = false;
+        return;
+    }
+    fileBuffer += "=== Log Rotated: " + FormatTimestamp(std::chrono::system_clock::now()) + " ===\n";
+}
+
+std::vector<std::string> Logger::GetLogsSince(std::chrono::system_clock::time_point since) {
+    Flush();
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::vector<std::string> lines;
+    for (uint64_t sequence = logCount; sequence > GetOldestLog() && LogAt(sequence - 1).time >= since; sequence--) {
+        const LogMessage& log = LogAt(sequence - 1);
+        std::ostringstream oss;
+        oss << "[" << FormatTimestamp(log.time) << "] [" << LevelToString(log.level) << "] " << log.message;
+        if (log.errorCode != 0) oss << " (Error: " << log.errorCode << ")";
+        lines.push_back(oss.str());
+    }
+    std::reverse(lines.begin(), lines.end());
+    return lines;
+}
+
 size_t getTerminalWidth() {
 #ifdef _WIN32
     CONSOLE_SCREEN_BUFFER_INFO csbi;
@@ -277,26 +413,24 @@ void Logger::AddLog(LogMessage&& log) {
     auto timeLimit = std::chrono::system_clock::now() - std::chrono::seconds(3);
     
     bool isDuplicate = false;
-    size_t duplicateIndex = 0;
+    uint64_t duplicateIndex = 0;
     size_t dstUp = 0;
     
-    // Chercher en partant de la fin, sécurisé contre les vecteurs vides
-    if (!logs.empty()) {
-        for (size_t i = logs.size(); i > 0; i--) {
-            size_t idx = i - 1;  // Index réel
-            
-            if (logs[idx].time < timeLimit) {
-                break;  // Trop ancien, arrêter la recherche
-            }
-            
-            dstUp += CalculateNumberOfLines(logs[idx]);
-            
-            if (logs[idx] == log) {
-                logs[idx].repetition++;  // Modifier l'original dans le vecteur
-                duplicateIndex = idx;
-                isDuplicate = true;
-                break;
-            }
+    // Chercher en partant de la fin, seulement parmi les messages encore gardés
+    for (uint64_t i = logCount; i > GetOldestLog(); i--) {
+        LogMessage& previous = LogAt(i - 1);
+        
+        if (previous.time < timeLimit) {
+            break;  // Trop ancien, arrêter la recherche
+        }
+        
+        dstUp += CalculateNumberOfLines(previous);
+        
+        if (previous == log) {
+            previous.repetition++;  // Modifier l'original dans l'historique
+            duplicateIndex = i - 1;
+            isDuplicate = true;
+            break;
         }
     }
 
@@ -304,7 +438,7 @@ void Logger::AddLog(LogMessage&& log) {
         // Remonter à la ligne du duplicate
         std::cout << "\033[" << dstUp << "F";
         
-        const auto& duplicateLog = logs[duplicateIndex];
+        const auto& duplicateLog = LogAt(duplicateIndex);
         bool needFullRewrite = std::to_string(duplicateLog.repetition).size() != 
                               std::to_string(duplicateLog.repetition - 1).size() ||
                               duplicateLog.repetition == 2;
@@ -322,16 +456,212 @@ void Logger::AddLog(LogMessage&& log) {
         // Redescendre à la position originale
         std::cout << "\033[" << dstUp - (needFullRewrite ? 1 : 0) << "E";
     } else {
-        logs.push_back(std::move(log));
-        PrintLog(logs.back());
+        // The oldest message is overwritten once the history is full
+        if (logs.size() < LOGGER_HISTORY_CAPACITY) {
+            logs.push_back(std::move(log));
+        } else {
+            LogAt(logCount) = std::move(log);
+        }
+        const LogMessage& added = LogAt(logCount++);
+        BufferToFile(added);
+        PrintLog(added);
         
-        if (logs.back().level == L_FATAL) {
+        // The thread that logged it exits once the writer is done, see Submit
+        if (added.level == L_FATAL && !isWriterThread) {
             std::exit(1);
         }
     }
 }
 
 
+std::ostringstream& Logger::FormatBuffer() {
+    // One stream per thread shared by every LogError instantiation, past the first messages formatting does not allocate
+    thread_local std::ostringstream oss;
+    oss.clear();
+    oss.seekp(0);
+    oss.flags(std::ios_base::dec | std::ios_base::skipws);
+    oss.precision(6);
+    oss.width(0);
+    oss.fill(' ');
+    return oss;
+}
+
+void Logger::Submit(
+    LogLevel level,
+#ifdef DEBUG
+    const std::string& file,
+    int line,
+#endif
+    int errorCode,
+    std::string_view message)
+{
+    AsyncLogState& state = GetAsyncState();
+    // Counted before running is read, so StopAsync cannot miss a message already on its way to the queue
+    bool async = false;
+    if (!isWriterThread) {
+        state.producers.fetch_add(1, std::memory_order_seq_cst);
+        async = state.running.load(std::memory_order_seq_cst);
+        if (!async) state.producers.fetch_sub(1, std::memory_order_release);
+    }
+    if (!async) {
+        LogMessage msg;
+        msg.level = level;
+        msg.time = std::chrono::system_clock::now();
+#ifdef DEBUG
+        msg.file = file;
+        msg.line = line;
+#endif
+        msg.message = message;
+        msg.errorCode = errorCode;
+        AddLog(std::move(msg));
+        return;
+    }
+
+    const bool important = level >= L_WARNING;
+    if (state.policy == LOG_OVERFLOW_SAMPLE && !important && state.queue.GetSize() >= LOGGER_QUEUE_CAPACITY / 2 &&
+        state.sampled.fetch_add(1, std::memory_order_relaxed) % LOGGER_SAMPLE_RATE != 0) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        state.producers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    auto write = [&](LogRecord& record) {
+        record.level = level;
+        record.errorCode = errorCode;
+        record.time = std::chrono::system_clock::now();
+#ifdef DEBUG
+        record.file = file;
+        record.line = line;
+#endif
+        record.message.assign(message);
+    };
+    const bool wait = level == L_FATAL || state.policy == LOG_OVERFLOW_BLOCK || (state.policy == LOG_OVERFLOW_SAMPLE && important);
+    while (!state.queue.TryEmplace(write)) {
+        if (!wait) {
+            state.dropped.fetch_add(1, std::memory_order_relaxed);
+            state.producers.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        WakeWriter(state);
+        std::this_thread::yield();
+    }
+    state.producers.fetch_sub(1, std::memory_order_release);
+
+    if (level == L_FATAL) {
+        Flush();
+        std::exit(1);
+    }
+    // Past half full the writer is woken instead of waiting for its interval
+    if (state.queue.GetSize() >= LOGGER_QUEUE_CAPACITY / 2) WakeWriter(state);
+}
+
+void Logger::StartAsync(LogOverflowPolicy policy) {
+    AsyncLogState& state = GetAsyncState();
+    if (state.running.load(std::memory_order_acquire)) return;
+    state.policy = policy;
+    state.running.store(true, std::memory_order_release);
+    state.writer = std::thread(&Logger::WriterLoop);
+}
+
+void Logger::StopAsync() {
+    AsyncLogState& state = GetAsyncState();
+    std::lock_guard<std::mutex> stopLock(state.stopMutex);
+    if (!state.running.exchange(false, std::memory_order_seq_cst)) return;
+    WakeWriter(state);
+    // The writer keeps draining until the producers that saw it running are done
+    if (state.writer.joinable()) state.writer.join();
+    // Messages pushed while the writer was finishing its last pass
+    DrainQueue();
+    { std::lock_guard<std::mutex> lock(state.wakeMutex); }
+    state.idle.notify_all();
+}
+
+bool Logger::IsAsync() {
+    return GetAsyncState().running.load(std::memory_order_acquire);
+}
+
+void Logger::Flush() {
+    AsyncLogState& state = GetAsyncState();
+    if (isWriterThread) return;
+    if (!state.running.load(std::memory_order_acquire)) {
+        // A StopAsync in progress returns once everything is written
+        std::lock_guard<std::mutex> stopLock(state.stopMutex);
+        return;
+    }
+
+    // The ring position claimed last, the message this thread just logged included
+    const size_t target = state.queue.GetClaimed();
+    std::unique_lock<std::mutex> lock(state.wakeMutex);
+    state.flushers.fetch_add(1, std::memory_order_release);
+    state.wake.notify_one();
+    // Reached by the writer or by the final drain of StopAsync
+    state.idle.wait(lock, [&]() { return state.queue.GetConsumed() >= target; });
+    state.flushers.fetch_sub(1, std::memory_order_release);
+}
+
+uint64_t Logger::GetDroppedLogs() {
+    return GetAsyncState().dropped.load(std::memory_order_relaxed);
+}
+
+// The records are copied so the slots keep the capacity of their strings
+size_t Logger::DrainQueue() {
+    return GetAsyncState().queue.Drain([](const LogRecord& record) {
+        LogMessage msg;
+        msg.level = record.level;
+        msg.time = record.time;
+#ifdef DEBUG
+        msg.file = record.file;
+        msg.line = record.line;
+#endif
+        msg.message = record.message;
+        msg.errorCode = record.errorCode;
+        AddLog(std::move(msg));
+    });
+}
+
+void Logger::WriterLoop() {
+    isWriterThread = true;
+    AsyncLogState& state = GetAsyncState();
+    auto lastFileWrite = std::chrono::steady_clock::now();
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(state.wakeMutex);
+            state.wake.wait_for(lock, std::chrono::milliseconds(LOGGER_WRITER_INTERVAL_MS),
+                [&]() { return !state.running.load(std::memory_order_acquire) || state.flushers.load(std::memory_order_acquire) > 0; });
+        }
+        // Read before the last pass, so everything pushed before StopAsync is drained
+        const bool running = state.running.load(std::memory_order_acquire);
+
+        const size_t count = DrainQueue();
+        const uint64_t dropped = state.dropped.load(std::memory_order_relaxed);
+        if (dropped != state.reportedDropped) {
+            LogMessage msg;
+            msg.level = L_WARNING;
+            msg.time = std::chrono::system_clock::now();
+            msg.message = "Log writer behind, " + std::to_string(dropped - state.reportedDropped) + " messages dropped";
+            AddLog(std::move(msg));
+            state.reportedDropped = dropped;
+        }
+        if (count > 0) {
+            { std::lock_guard<std::mutex> lock(state.wakeMutex); }
+            state.idle.notify_all();
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastFileWrite >= std::chrono::milliseconds(LOGGER_FILE_WRITE_MS) || !running) {
+            lastFileWrite = now;
+            std::lock_guard<std::mutex> lock(logMutex);
+            if (isLoggingToFile) WriteFileBuffer();
+        }
+        if (!running) {
+            if (state.producers.load(std::memory_order_acquire) == 0) break;
+            std::this_thread::yield();
+        }
+    }
+}
+
+
 std::string Logger::FormatTimestamp(const std::chrono::time_point<std::chrono::system_clock>& timestamp) {
     auto time_t = std::chrono::system_clock::to_time_t(timestamp);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -0,0 +1,169 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedNs(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    // Results are written one per line, so reading them back needs no JSON library
+    bool ReadNumber(const std::string& line, const std::string& key, double& value) {
+        const size_t at = line.find("\"" + key + "\":");
+        if (at == std::string::npos) return false;
+        value = std::strtod(line.c_str() + at + key.size() + 3, nullptr);
+        return true;
+    }
+}
+
+void BenchSuite::Add(const std::string& name, uint64_t itemsPerBatch, std::function<void()> batch) {
+    if (!this->options.filter.empty() && name.find(this->options.filter) == std::string::npos) return;
+    this->entries.push_back({ name, itemsPerBatch, std::move(batch) });
+}
+
+BenchResult BenchSuite::Measure(const Entry& entry) const {
+    // Warmup, also gives the cost of one batch
+    uint64_t warmupBatches = 0;
+    const Clock::time_point warmupStart = Clock::now();
+    do {
+        entry.batch();
+        warmupBatches++;
+    } while (ElapsedNs(warmupStart) < this->options.warmupMs * 1e6);
+    const double batchNs = ElapsedNs(warmupStart) / warmupBatches;
+    const uint64_t batches = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(this->options.repetitionMs * 1e6 / batchNs)));
+
+    std::vector<double> samples;
+    samples.reserve(this->options.repetitions);
+    for (int rep = 0; rep < this->options.repetitions; rep++) {
+        const Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < batches; i++) {
+            entry.batch();
+        }
+        samples.push_back(ElapsedNs(start) / (batches * entry.itemsPerBatch));
+    }
+
+    BenchResult result;
+    result.name = entry.name;
+    result.items = batches * entry.itemsPerBatch;
+    std::sort(samples.begin(), samples.end());
+    result.min = samples.front();
+    result.max = samples.back();
+    const size_t mid = samples.size() / 2;
+    result.median = samples.size() % 2 == 1 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2.0;
+    for (double sample : samples) result.mean += sample;
+    result.mean /= samples.size();
+    for (double sample : samples) result.stddev += (sample - result.mean) * (sample - result.mean);
+    result.stddev = samples.size() > 1 ? std::sqrt(result.stddev / (samples.size() - 1)) : 0.0;
+    return result;
+}
+
+std::vector<std::string> BenchSuite::GetNames() const {
+    std::vector<std::string> names;
+    for (const Entry& entry : this->entries) names.push_back(entry.name);
+    return names;
+}
+
+const std::vector<BenchResult>& BenchSuite::Run() {
+    this->results.clear();
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "median ns" << std::setw(14) << "min ns"
+              << std::setw(10) << "stddev %" << "\n";
+    for (const Entry& entry : this->entries) {
+        const BenchResult result = this->Measure(entry);
+        std::cout << std::left << std::setw(44) << result.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << result.median << std::setw(14) << result.min
+                  << std::setw(9) << std::setprecision(1) << (result.mean > 0.0 ? result.stddev / result.mean * 100.0 : 0.0) << "%\n";
+        this->results.push_back(result);
+    }
+    return this->results;
+}
+
+bool BenchSuite::WriteJSON(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << path << "\n";
+        return false;
+    }
+
+    file << "{\"unit\":\"ns/item\",\"results\":[";
+    file << std::setprecision(6);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        file << (i == 0 ? "" : ",") << "\n{\"name\":\"" << result.name << "\",\"items\":" << result.items
+             << ",\"min\":" << result.min << ",\"median\":" << result.median << ",\"mean\":" << result.mean
+             << ",\"stddev\":" << result.stddev << ",\"max\":" << result.max << "}";
+    }
+    file << "\n]}\n";
+    return true;
+}
+
+bool BenchSuite::ReadJSON(const std::string& path, std::vector<BenchResult>& results) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << path << "\n";
+        return false;
+    }
+
+    results.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t name = line.find("\"name\":\"");
+        if (name == std::string::npos) continue;
+        const size_t end = line.find('"', name + 8);
+        if (end == std::string::npos) continue;
+
+        BenchResult result;
+        result.name = line.substr(name + 8, end - name - 8);
+        double items = 0.0;
+        if (!ReadNumber(line, "median", result.median)) continue;
+        ReadNumber(line, "items", items);
+        ReadNumber(line, "min", result.min);
+        ReadNumber(line, "mean", result.mean);
+        ReadNumber(line, "stddev", result.stddev);
+        ReadNumber(line, "max", result.max);
+        result.items = static_cast<uint64_t>(items);
+        results.push_back(result);
+    }
+    return true;
+}
+
+bool BenchSuite::Compare(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current, double threshold) {
+    std::unordered_map<std::string, const BenchResult*> byName;
+    for (const BenchResult& result : baseline) byName[result.name] = &result;
+
+    bool ok = true;
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "baseline ns" << std::setw(14) << "current ns"
+              << std::setw(10) << "change" << "\n";
+    for (const BenchResult& result : current) {
+        auto it = byName.find(result.name);
+        if (it == byName.end()) {
+            std::cout << std::left << std::setw(44) << result.name << std::right << std::setw(14) << "-" << std::setw(14)
+                      << std::fixed << std::setprecision(3) << result.median << "       new\n";
+            continue;
+        }
+        const double before = it->second->median;
+        const double change = before > 0.0 ? result.median / before - 1.0 : 0.0;
+        // Slower than the threshold, and by more than both runs' spread
+        const bool regression = change > threshold && result.median - before > result.stddev + it->second->stddev;
+        ok = ok && !regression;
+        std::cout << std::left << std::setw(44) << result.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << before << std::setw(14) << result.median << std::setw(9) << std::showpos
+                  << std::setprecision(1) << change * 100.0 << std::noshowpos << "%" << (regression ? "  REGRESSION" : "") << "\n";
+        byName.erase(it);
+    }
+    for (const auto& [name, result] : byName) {
+        std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(3) << std::setw(14)
+                  << result->median << std::setw(14) << "-" << "   removed\n";
+    }
+    return ok;
+}
\ No newline at end of file
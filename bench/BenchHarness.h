@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BENCH_DEFAULT_REPETITIONS 15
+#define BENCH_DEFAULT_WARMUP_MS 100
+#define BENCH_DEFAULT_REPETITION_MS 20
+#define BENCH_DEFAULT_THRESHOLD 0.05
+
+// Keeps the compiler from dropping a result nobody reads
+template <typename Type>
+inline void DoNotOptimize(const Type& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchOptions
+{
+    int repetitions = BENCH_DEFAULT_REPETITIONS;
+    int warmupMs = BENCH_DEFAULT_WARMUP_MS;
+    int repetitionMs = BENCH_DEFAULT_REPETITION_MS; // Minimum length of a repetition, sets the batch count
+    std::string filter; // Substring of the names to run, empty = all
+};
+
+// Nanoseconds per item over the repetitions
+struct BenchResult
+{
+    std::string name;
+    uint64_t items = 0; // Items per repetition
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double max = 0.0;
+};
+
+// Every benchmark is a batch function processing a fixed number of items.
+// After a timed warmup the batch count is scaled so one repetition lasts at
+// least repetitionMs, then each repetition is timed on its own.
+class BenchSuite
+{
+public:
+    explicit BenchSuite(const BenchOptions& options) : options(options) {}
+
+    void Add(const std::string& name, uint64_t itemsPerBatch, std::function<void()> batch);
+    // Runs every registered benchmark, printing one line each
+    const std::vector<BenchResult>& Run();
+    std::vector<std::string> GetNames() const;
+
+    static bool WriteJSON(const std::string& path, const std::vector<BenchResult>& results);
+    static bool ReadJSON(const std::string& path, std::vector<BenchResult>& results);
+    // Prints the median change of each benchmark, returns false when one got slower than threshold
+    static bool Compare(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current, double threshold);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        uint64_t itemsPerBatch;
+        std::function<void()> batch;
+    };
+
+    BenchResult Measure(const Entry& entry) const;
+
+    BenchOptions options;
+    std::vector<Entry> entries;
+    std::vector<BenchResult> results;
+};
\ No newline at end of file
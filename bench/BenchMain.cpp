@@ -0,0 +1,251 @@
+// Micro-benchmarks of the CPU hot paths: noise, random numbers, grid
+// generation/packing and the profiler ring buffer. Built by `make bench`,
+// headless, results are written as JSON and can be compared between runs.
+
+#include "BenchHarness.h"
+
+#include "Grid.h"
+#include "Logger.h"
+#include "Noise.h"
+#include "Random.h"
+#include "RingBuffer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define BENCH_NOISE_BATCH 4096
+#define BENCH_RANDOM_BATCH 65536
+#define BENCH_RING_BATCH 4096
+#define BENCH_SEED 1337
+
+struct BenchCLIOptions
+{
+    BenchOptions bench;
+    std::string output = "bench_results.json";
+    std::string baseline;
+    std::string compareA;
+    std::string compareB;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    bool list = false;
+};
+
+static void PrintUsage() {
+    std::cout <<
+        "Usage: bench [options]\n"
+        "  --filter <text>          only run benchmarks whose name contains text\n"
+        "  --repetitions <int>      timed repetitions per benchmark (default 15)\n"
+        "  --warmup <ms>            warmup per benchmark (default 100)\n"
+        "  --min-time <ms>          minimum length of a repetition (default 20)\n"
+        "  --out <file>             JSON results (default bench_results.json), empty = none\n"
+        "  --baseline <file>        compare this run against a previous JSON result\n"
+        "  --compare <old> <new>    only compare two JSON results\n"
+        "  --threshold <percent>    median slowdown counted as a regression (default 5)\n"
+        "  --list                   print the benchmark names and exit\n";
+}
+
+static bool ParseArguments(int argc, char** argv, BenchCLIOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                LOG_ERROR(1, "Missing value for ", arg);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        const char* value = nullptr;
+
+        if (arg == "--help" || arg == "-h") { PrintUsage(); std::exit(EXIT_SUCCESS); }
+        else if (arg == "--list") { options.list = true; continue; }
+
+        if (!(value = next())) return false;
+        if (arg == "--filter") options.bench.filter = value;
+        else if (arg == "--repetitions") options.bench.repetitions = std::max(1, std::atoi(value));
+        else if (arg == "--warmup") options.bench.warmupMs = std::max(0, std::atoi(value));
+        else if (arg == "--min-time") options.bench.repetitionMs = std::max(1, std::atoi(value));
+        else if (arg == "--out") options.output = value;
+        else if (arg == "--baseline") options.baseline = value;
+        else if (arg == "--threshold") options.threshold = std::strtod(value, nullptr) / 100.0;
+        else if (arg == "--compare") {
+            options.compareA = value;
+            if (!(value = next())) return false;
+            options.compareB = value;
+        }
+        else {
+            LOG_ERROR(1, "Unknown argument ", arg);
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Coordinates walk a fixed pattern so every call hits a different lattice cell
+static void AddNoiseBenchmarks(BenchSuite& suite, Noise& noise) {
+    const float scale = 0.01f;
+    const int octaves = 8;
+    const float persistence = 0.5f;
+    const float lacunarity = 2.0f;
+    auto coord = [](int i, float axis) { return static_cast<float>(i) * 0.731f + axis * 17.3f; };
+
+    suite.Add("Noise/White/1D", BENCH_NOISE_BATCH, [&noise, coord]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.WhiteNoise(coord(i, 0)));
+    });
+    suite.Add("Noise/White/2D", BENCH_NOISE_BATCH, [&noise, coord]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.WhiteNoise(coord(i, 0), coord(i, 1)));
+    });
+    suite.Add("Noise/White/3D", BENCH_NOISE_BATCH, [&noise, coord]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.WhiteNoise(coord(i, 0), coord(i, 1), coord(i, 2)));
+    });
+    suite.Add("Noise/White/4D", BENCH_NOISE_BATCH, [&noise, coord]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.WhiteNoise(coord(i, 0), coord(i, 1), coord(i, 2), coord(i, 3)));
+    });
+
+    suite.Add("Noise/Smooth/1D", BENCH_NOISE_BATCH, [&noise, coord, scale]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.SmoothNoise(coord(i, 0), scale));
+    });
+    suite.Add("Noise/Smooth/2D", BENCH_NOISE_BATCH, [&noise, coord, scale]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.SmoothNoise(coord(i, 0), coord(i, 1), scale));
+    });
+    suite.Add("Noise/Smooth/3D", BENCH_NOISE_BATCH, [&noise, coord, scale]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.SmoothNoise(coord(i, 0), coord(i, 1), coord(i, 2), scale));
+    });
+    suite.Add("Noise/Smooth/4D", BENCH_NOISE_BATCH, [&noise, coord, scale]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++) DoNotOptimize(noise.SmoothNoise(coord(i, 0), coord(i, 1), coord(i, 2), coord(i, 3), scale));
+    });
+
+    suite.Add("Noise/Fractal/1D", BENCH_NOISE_BATCH, [=, &noise]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++)
+            DoNotOptimize(noise.FractalNoise(coord(i, 0), scale, octaves, persistence, lacunarity));
+    });
+    suite.Add("Noise/Fractal/2D", BENCH_NOISE_BATCH, [=, &noise]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++)
+            DoNotOptimize(noise.FractalNoise(coord(i, 0), coord(i, 1), scale, octaves, persistence, lacunarity));
+    });
+    suite.Add("Noise/Fractal/3D", BENCH_NOISE_BATCH, [=, &noise]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++)
+            DoNotOptimize(noise.FractalNoise(coord(i, 0), coord(i, 1), coord(i, 2), scale, octaves, persistence, lacunarity));
+    });
+    suite.Add("Noise/Fractal/4D", BENCH_NOISE_BATCH, [=, &noise]() {
+        for (int i = 0; i < BENCH_NOISE_BATCH; i++)
+            DoNotOptimize(noise.FractalNoise(coord(i, 0), coord(i, 1), coord(i, 2), coord(i, 3), scale, octaves, persistence, lacunarity));
+    });
+}
+
+static void AddRandomBenchmarks(BenchSuite& suite, PCGRandom& random) {
+    suite.Add("PCGRandom/next", BENCH_RANDOM_BATCH, [&random]() {
+        for (int i = 0; i < BENCH_RANDOM_BATCH; i++) DoNotOptimize(random.next());
+    });
+    suite.Add("PCGRandom/nextRange", BENCH_RANDOM_BATCH, [&random]() {
+        for (int i = 0; i < BENCH_RANDOM_BATCH; i++) DoNotOptimize(random.next(10, 1000));
+    });
+    suite.Add("PCGRandom/nextFloat", BENCH_RANDOM_BATCH, [&random]() {
+        for (int i = 0; i < BENCH_RANDOM_BATCH; i++) DoNotOptimize(random.nextFloat());
+    });
+    suite.Add("PCGRandom/nextFloatRange", BENCH_RANDOM_BATCH, [&random]() {
+        for (int i = 0; i < BENCH_RANDOM_BATCH; i++) DoNotOptimize(random.nextFloat(-1.0f, 1.0f));
+    });
+}
+
+// Items are vertices, so the grid sizes can be compared with each other
+static void AddGridBenchmarks(BenchSuite& suite, std::vector<Grid>& grids, std::vector<float>& packed) {
+    for (Grid& grid : grids) {
+        const unsigned int resolution = grid.GetResolutionX();
+        const uint64_t vertices = static_cast<uint64_t>(resolution) * resolution;
+        const std::string size = "/" + std::to_string(resolution);
+
+        suite.Add("Grid/GeneratePoints" + size, vertices, [&grid]() { grid.GeneratePoints(); });
+        suite.Add("Grid/GenerateTriangles" + size, vertices, [&grid]() { grid.GenerateTriangles(); });
+        suite.Add("Grid/GenerateNormals" + size, vertices, [&grid]() { grid.GenerateNormals(); });
+        suite.Add("Grid/PackVertices" + size, vertices, [&grid, &packed]() {
+            grid.PackVertices(packed);
+            DoNotOptimize(packed.data());
+        });
+        suite.Add("Grid/GenerateIndices" + size, vertices, [resolution]() {
+            std::vector<unsigned int> indices = Grid::GenerateIndices(resolution, resolution);
+            DoNotOptimize(indices.data());
+        });
+    }
+}
+
+struct RingCase
+{
+    RingBuffer<std::chrono::nanoseconds> ring;
+    bool percentiles;
+    uint64_t state = BENCH_SEED;
+
+    RingCase(size_t window, bool percentiles) : ring(window), percentiles(percentiles) {
+        if (percentiles) this->ring.EnablePercentiles();
+    }
+};
+
+// Push plus every statistic the profiler overlay reads each frame
+static void AddRingBufferBenchmarks(BenchSuite& suite, std::vector<RingCase>& rings) {
+    for (RingCase& ring : rings) {
+        const std::string name = std::string(ring.percentiles ? "RingBuffer/PushPercentiles/" : "RingBuffer/PushStats/")
+            + std::to_string(ring.ring.GetCapacity());
+
+        suite.Add(name, BENCH_RING_BATCH, [&ring]() {
+            for (int i = 0; i < BENCH_RING_BATCH; i++) {
+                ring.ring.Push(std::chrono::nanoseconds(PCGRandom::Random(ring.state, 100000, 20000000)));
+                DoNotOptimize(ring.ring.GetAverage());
+                DoNotOptimize(ring.ring.GetMin());
+                DoNotOptimize(ring.ring.GetMax());
+                if (ring.percentiles) DoNotOptimize(ring.ring.GetPercentile(99.0));
+            }
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchCLIOptions options;
+    if (!ParseArguments(argc, argv, options)) return EXIT_FAILURE;
+
+    if (!options.compareA.empty()) {
+        std::vector<BenchResult> baseline, current;
+        if (!BenchSuite::ReadJSON(options.compareA, baseline) || !BenchSuite::ReadJSON(options.compareB, current)) return EXIT_FAILURE;
+        return BenchSuite::Compare(baseline, current, options.threshold) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Everything the benchmarks touch lives here, the suite only keeps references
+    Noise noise(BENCH_SEED);
+    PCGRandom random(BENCH_SEED);
+    std::vector<Grid> grids;
+    grids.reserve(3);
+    for (int resolution : { 64, 256, 1024 }) {
+        grids.emplace_back(static_cast<float>(resolution), static_cast<float>(resolution), resolution, resolution);
+    }
+    std::vector<float> packed;
+    std::vector<RingCase> rings;
+    rings.reserve(4);
+    for (size_t window : { 64, 512, 4096 }) rings.emplace_back(window, false);
+    rings.emplace_back(512, true);
+
+    BenchSuite suite(options.bench);
+    AddNoiseBenchmarks(suite, noise);
+    AddRandomBenchmarks(suite, random);
+    AddGridBenchmarks(suite, grids, packed);
+    AddRingBufferBenchmarks(suite, rings);
+
+    if (options.list) {
+        for (const std::string& name : suite.GetNames()) std::cout << name << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    const std::vector<BenchResult>& results = suite.Run();
+    if (!options.output.empty()) {
+        if (!BenchSuite::WriteJSON(options.output, results)) return EXIT_FAILURE;
+        std::cout << "Results written to " << options.output << "\n";
+    }
+
+    if (!options.baseline.empty()) {
+        std::vector<BenchResult> baseline;
+        if (!BenchSuite::ReadJSON(options.baseline, baseline)) return EXIT_FAILURE;
+        std::cout << "\n";
+        return BenchSuite::Compare(baseline, results, options.threshold) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
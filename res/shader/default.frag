@@ -14,13 +14,21 @@ layout(binding = 0, std140) uniform CamBlock {
 } camera;
 
 
+// Must match ClusteredLighting.h
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define LIGHT_CUTOFF 0.01f
+
 struct LightStruct
 {
    int type;
+   int _pad0[3];
 
-   vec3 position;
-   vec3 direction;
-   vec3 color;
+   vec4 position;
+   vec4 direction;
+   vec4 color;
 
    float strength;
 
@@ -40,6 +48,20 @@ layout(std430, binding = 1) buffer LightBlock {
    LightStruct lights[];   
 } lights;
 
+layout(std140, binding = 4) uniform ClusterBlock {
+   mat4 view;
+   mat4 inverseProjection;
+   vec4 planes;
+} clusters;
+
+layout(std430, binding = 5) readonly buffer LightGrid {
+   uint lightCounts[];
+} grid;
+
+layout(std430, binding = 6) readonly buffer LightIndices {
+   uint lightIndices[];
+} indexList;
+
 
 
 vec4 directLight(vec3 lightDirection, vec3 lightColor, float lightIntensity) {
@@ -62,15 +84,53 @@ vec4 wireframeRender() {
    return vec4(0.0f);
 }
 
+// Falloff shifted by the cutoff so it reaches 0 exactly at the culling range
+float attenuation(LightStruct lght, float dist) {
+   return max(lght.strength / (lght.a * dist * dist + lght.b * dist + 1.0f) - LIGHT_CUTOFF, 0.0f);
+}
+
+vec4 pointLight(LightStruct lght) {
+   vec3 lightVec = lght.position.xyz - crntPos;
+   return directLight(lightVec, lght.color.rgb, attenuation(lght, length(lightVec)));
+}
+
+vec4 spotLight(LightStruct lght) {
+   vec3 lightVec = lght.position.xyz - crntPos;
+   float angle = dot(normalize(lght.direction.xyz), -normalize(lightVec));
+   float cone = clamp((angle - lght.outerCone) / (lght.innerCone - lght.outerCone), 0.0f, 1.0f);
+   return directLight(lightVec, lght.color.rgb, attenuation(lght, length(lightVec)) * cone);
+}
+
+uint clusterIndex() {
+   vec4 clip = camera.matrix * vec4(crntPos, 1.0f);
+   vec2 tile = (clip.xy / clip.w * 0.5f + 0.5f) * vec2(CLUSTER_X, CLUSTER_Y);
+   uvec2 xy = uvec2(clamp(tile, vec2(0.0f), vec2(CLUSTER_X - 1, CLUSTER_Y - 1)));
+
+   float depth = -(clusters.view * vec4(crntPos, 1.0f)).z;
+   float near = clusters.planes.x;
+   float far = clusters.planes.y;
+   float slice = log(max(depth, near) / near) / log(far / near) * CLUSTER_Z;
+   uint z = uint(clamp(slice, 0.0f, float(CLUSTER_Z - 1)));
+
+   return xy.x + xy.y * CLUSTER_X + z * CLUSTER_X * CLUSTER_Y;
+}
+
 vec4 fillRender() {
 
    vec4 l = vec4(lights.AmbientLightColor.rgb * lights.AmbientLightStrength, 1.0f);
-   for(int i = 0; i < lights.size; i++) {
-      LightStruct lght = lights.lights[i];
+
+   uint cluster = clusterIndex();
+   uint count = grid.lightCounts[cluster];
+   for(uint i = 0u; i < count; i++) {
+      LightStruct lght = lights.lights[indexList.lightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
       if (lght.type == 1) {
-         l += vec4(lght.color * lght.strength, 1.0f);
+         l += vec4(lght.color.rgb * lght.strength, 1.0f);
       } else if (lght.type == 2) {
-         l += directLight(lght.direction, lght.color, lght.strength);
+         l += directLight(lght.direction.xyz, lght.color.rgb, lght.strength);
+      } else if (lght.type == 3) {
+         l += pointLight(lght);
+      } else if (lght.type == 4) {
+         l += spotLight(lght);
       }
    }
    
@@ -3,6 +3,7 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
+layout (location = 7) in uint aDrawID;
 
 
 layout(binding = 0, std140) uniform CamBlock {
@@ -10,9 +11,9 @@ layout(binding = 0, std140) uniform CamBlock {
    mat4 matrix;
 } camera;
 
-layout(binding = 3, std140) uniform ModelBlock {
-   mat4 model;
-} model;
+layout(binding = 3, std430) readonly buffer ObjectTransforms {
+   mat4 models[];
+} transforms;
 
 out vec3 normal;
 out vec3 crntPos;
@@ -20,7 +21,7 @@ out vec3 color;
 
 void main()
 {
-   crntPos = vec3(model.model * vec4(aPos, 1.0f));
+   crntPos = vec3(transforms.models[aDrawID] * vec4(aPos, 1.0f));
    normal = aNormal;
    color = aColor;
    
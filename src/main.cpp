@@ -1,9 +1,10 @@
 #include "Game.h"
+#include "GameOptions.h"
 #include "Logger.h"
 
 #include <iostream>
 
-int main() {
+int main(int argc, char** argv) {
 	SetWorkingDirectoryToExe();
 
 #ifdef DEBUG
@@ -13,6 +14,12 @@ int main() {
 #endif
 
 
+	GameOptions options;
+	if (!ParseGameOptions(argc, argv, options))
+		return EXIT_FAILURE;
+	if (options.asyncLog)
+		Logger::StartAsync(options.logOverflow);
+
 	if (!Window::InitOpenGL())
 		return EXIT_FAILURE;
 
@@ -20,13 +27,15 @@ int main() {
 
 	Game game;
 	LOG_TRACE("Game created");
-	game.init();
+	game.init(options);
 	LOG_TRACE("Game initialized");
 	game.run();
 	game.stop();
+	const int exitCode = game.GetExitCode();
 
 	LOG_INFO("Game stopped");
 	Window::TerminateOpenGL();
+	Logger::StopAsync();
 	FLUSH_LOG_TO_FILE;
-	return EXIT_SUCCESS;
+	return exitCode;
 }
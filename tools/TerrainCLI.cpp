@@ -0,0 +1,305 @@
+// Headless terrain generation: builds many seeds/tiles in parallel and writes
+// heightmaps/meshes plus timing statistics, without any window or GL context.
+
+#include "TerrainGenerator.h"
+#include "TerrainExporter.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CLIOptions
+{
+    int seed = 0;
+    int seedCount = 1;
+    int tiles = 1;
+    float size = 500.0f;
+    int resolution = 500;
+    float scale = 0.01f;
+    float height = 50.0f;
+    int octaves = 10;
+    float persistence = 0.5f;
+    float lacunarity = 2.0f;
+    unsigned int threads = 0;
+    std::string output = "terrain_out";
+    std::vector<std::string> formats = { "raw16" };
+    bool benchmarkKernel = false;
+    int iterations = 5;
+};
+
+struct TileJob
+{
+    int seed;
+    int tileX;
+    int tileZ;
+    double milliseconds = 0.0;
+    float minHeight = 0.0f;
+    float maxHeight = 0.0f;
+};
+
+static void PrintUsage() {
+    std::cout <<
+        "Usage: terrain-cli [options]\n"
+        "  --seed <int>          first seed (default 0)\n"
+        "  --seeds <int>         number of consecutive seeds (default 1)\n"
+        "  --tiles <int>         tiles per side for each seed (default 1)\n"
+        "  --size <float>        world size of a tile (default 500)\n"
+        "  --resolution <int>    vertices per tile side (default 500)\n"
+        "  --scale <float>       noise scale (default 0.01)\n"
+        "  --height <float>      height multiplier (default 50)\n"
+        "  --octaves <int>       fractal octaves (default 10)\n"
+        "  --persistence <float> fractal persistence (default 0.5)\n"
+        "  --lacunarity <float>  fractal lacunarity (default 2)\n"
+        "  --threads <int>       worker threads, 0 = hardware (default 0)\n"
+        "  --output <dir>        output directory (default terrain_out)\n"
+        "  --format <list>       comma separated: r32, raw16, png16, mesh (default raw16)\n"
+        "  --no-output           only generate and time, write nothing but stats\n"
+        "  --benchmark-kernel    compare the multi-pass and fused tile pipelines at --resolution\n"
+        "  --iterations <int>    repetitions for --benchmark-kernel, best is kept (default 5)\n";
+}
+
+static bool ParseArguments(int argc, char** argv, CLIOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                LOG_ERROR(1, "Missing value for ", arg);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* value = nullptr;
+        if (arg == "--help" || arg == "-h") { PrintUsage(); std::exit(EXIT_SUCCESS); }
+        else if (arg == "--no-output") { options.formats.clear(); continue; }
+        else if (arg == "--benchmark-kernel") { options.benchmarkKernel = true; continue; }
+
+        if (!(value = next())) return false;
+        if (arg == "--seed") options.seed = std::atoi(value);
+        else if (arg == "--seeds") options.seedCount = std::max(1, std::atoi(value));
+        else if (arg == "--tiles") options.tiles = std::max(1, std::atoi(value));
+        else if (arg == "--size") options.size = std::strtof(value, nullptr);
+        else if (arg == "--resolution") options.resolution = std::max(2, std::atoi(value));
+        else if (arg == "--scale") options.scale = std::strtof(value, nullptr);
+        else if (arg == "--height") options.height = std::strtof(value, nullptr);
+        else if (arg == "--octaves") options.octaves = std::max(1, std::atoi(value));
+        else if (arg == "--persistence") options.persistence = std::strtof(value, nullptr);
+        else if (arg == "--lacunarity") options.lacunarity = std::strtof(value, nullptr);
+        else if (arg == "--threads") options.threads = static_cast<unsigned int>(std::max(0, std::atoi(value)));
+        else if (arg == "--iterations") options.iterations = std::max(1, std::atoi(value));
+        else if (arg == "--output") options.output = value;
+        else if (arg == "--format") {
+            options.formats.clear();
+            std::string list = value;
+            for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+                end = std::min(list.find(',', start), list.size());
+                std::string format = list.substr(start, end - start);
+                if (format != "r32" && format != "raw16" && format != "png16" && format != "mesh") {
+                    LOG_ERROR(1, "Unknown format ", format);
+                    return false;
+                }
+                options.formats.push_back(format);
+            }
+        }
+        else {
+            LOG_ERROR(1, "Unknown argument ", arg);
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string TileName(const TileJob& job) {
+    return "seed" + std::to_string(job.seed) + "_x" + std::to_string(job.tileX) + "_z" + std::to_string(job.tileZ);
+}
+
+static bool Export(const Grid& grid, const std::string& format, const std::filesystem::path& base) {
+    if (format == "r32") return TerrainExporter::ExportRAW32(grid, base.string() + ".r32");
+    if (format == "raw16") return TerrainExporter::ExportRAW16(grid, base.string() + ".raw");
+    if (format == "png16") return TerrainExporter::ExportPNG16(grid, base.string() + ".png");
+    if (format == "mesh") return TerrainExporter::ExportMesh(grid, base.string() + ".pmsh");
+    return false;
+}
+
+static void RunJob(const CLIOptions& options, TileJob& job) {
+    auto start = std::chrono::steady_clock::now();
+
+    TerrainGenerator generator(options.size, options.size, options.resolution, options.resolution, job.seed);
+    generator.SetOrigin(glm::vec2(job.tileX * options.size, job.tileZ * options.size));
+    generator.GenerateFractalTerrain(options.scale, options.height, options.octaves, options.persistence, options.lacunarity);
+
+    auto end = std::chrono::steady_clock::now();
+    job.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    const Grid& grid = generator.GetGrid();
+    job.minHeight = grid.GetHeightfield().GetMinHeight();
+    job.maxHeight = grid.GetHeightfield().GetMaxHeight();
+
+    std::filesystem::path base = std::filesystem::path(options.output) / TileName(job);
+    for (const std::string& format : options.formats) {
+        if (!Export(grid, format, base)) {
+            LOG_ERROR(2, "Failed to export ", TileName(job), " as ", format);
+        }
+    }
+}
+
+static void RunKernelBenchmark(const CLIOptions& options) {
+    Noise noise(options.seed);
+    // flat, white and fractal are the bodies of the TerrainGenerator generators
+    auto flat = [](Vertex& vertex, unsigned int) {
+        vertex.Position.y = 0.0f;
+    };
+    auto white = [&](Vertex& vertex, unsigned int) {
+        float r = noise.WhiteNoise(vertex.Position.x, vertex.Position.z);
+        vertex.Position.y = r * options.height;
+        vertex.Color = glm::vec3(r, 0.0f, 0.0f);
+    };
+    auto analytic = [](Vertex& vertex, unsigned int) {
+        vertex.Position.y = std::sin(vertex.Position.x * 0.05f) * std::cos(vertex.Position.z * 0.05f);
+        vertex.Color = glm::vec3(vertex.Position.y, 0.0f, -vertex.Position.y);
+    };
+    auto fractal = [&](Vertex& vertex, unsigned int) {
+        float r = noise.FractalNoise(vertex.Position.x, vertex.Position.z, options.scale, options.octaves, options.persistence, options.lacunarity);
+        vertex.Position.y = r * options.height;
+        vertex.Color = glm::vec3(r, 0.0f, -r);
+    };
+
+    Grid grid;
+    grid.init(options.size, options.size, options.resolution, options.resolution);
+    Grid fusedGrid(grid);
+    std::vector<float> packed;
+    std::vector<float> fusedPacked;
+    const double vertices = static_cast<double>(options.resolution) * options.resolution;
+
+    auto best = [&](const std::function<void()>& run) {
+        double result = 0.0;
+        for (int k = 0; k < options.iterations; k++) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            result = (k == 0) ? ms : std::min(result, ms);
+        }
+        return result;
+    };
+
+    std::cout << "Kernel benchmark " << options.resolution << "x" << options.resolution
+              << ", best of " << options.iterations << ", generators run the "
+              << (vertices >= FUSED_MIN_POINTS ? "fused" : "multi-pass") << " pipeline at this size\n"
+              << std::fixed << std::setprecision(3);
+    const std::pair<const char*, std::function<void(Vertex&, unsigned int)>> workloads[] = {
+        { "flat", flat },
+        { "white", white },
+        { "analytic", analytic },
+        { "fractal", fractal }
+    };
+    for (const auto& [name, func] : workloads) {
+        double multi = best([&]() {
+            grid.TransformPoints(func);
+            grid.PackVertices(packed);
+        });
+        double fused = best([&]() {
+            fusedGrid.TransformPointsFused(func, true);
+        });
+
+        // Both pipelines write the vertices back, compare what they would upload
+        fusedGrid.PackVertices(fusedPacked);
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < packed.size() && i < fusedPacked.size(); i++) {
+            maxDifference = std::max(maxDifference, std::abs(packed[i] - fusedPacked[i]));
+        }
+        if (packed.size() != fusedPacked.size()) maxDifference = INFINITY;
+
+        std::cout << "  " << std::left << std::setw(9) << name << std::right
+                  << " multi-pass " << std::setw(10) << multi << " ms (" << vertices / (multi * 1e3) << " Mvert/s)"
+                  << " | fused " << std::setw(10) << fused << " ms (" << vertices / (fused * 1e3) << " Mvert/s)"
+                  << " | fused speedup x" << multi / fused
+                  << " | max |diff| " << std::scientific << maxDifference << std::fixed << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    CLIOptions options;
+    if (!ParseArguments(argc, argv, options)) return EXIT_FAILURE;
+
+    if (options.benchmarkKernel) {
+        RunKernelBenchmark(options);
+        return EXIT_SUCCESS;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.output, error);
+    if (error) {
+        LOG_ERROR(2, "Cannot create output directory ", options.output, ": ", error.message());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<TileJob> jobs;
+    jobs.reserve(options.seedCount * options.tiles * options.tiles);
+    for (int s = 0; s < options.seedCount; s++) {
+        for (int x = 0; x < options.tiles; x++) {
+            for (int z = 0; z < options.tiles; z++) {
+                jobs.push_back({ options.seed + s, x, z });
+            }
+        }
+    }
+
+    unsigned int threadCount = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned int>(threadCount, jobs.size());
+
+    std::atomic<size_t> nextJob = 0;
+    auto worker = [&]() {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+            RunJob(options, jobs[i]);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> times;
+    times.reserve(jobs.size());
+    for (const auto& job : jobs) times.push_back(job.milliseconds);
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double t : times) total += t;
+    auto percentile = [&times](double p) { return times[std::min(times.size() - 1, static_cast<size_t>(p * times.size()))]; };
+
+    double vertices = static_cast<double>(jobs.size()) * options.resolution * options.resolution;
+
+    std::ofstream stats(std::filesystem::path(options.output) / "stats.csv");
+    // 16-bit outputs map [min_height, max_height] to [0, 65535]
+    stats << "seed,tile_x,tile_z,ms,min_height,max_height\n";
+    for (const auto& job : jobs) {
+        stats << job.seed << "," << job.tileX << "," << job.tileZ << "," << job.milliseconds << ","
+              << job.minHeight << "," << job.maxHeight << "\n";
+    }
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Tiles:        " << jobs.size() << " (" << options.resolution << "x" << options.resolution << ", " << threadCount << " threads)\n"
+              << "Wall time:    " << wallMs << " ms\n"
+              << "Tile time:    min " << times.front() << " / avg " << total / times.size()
+              << " / p95 " << percentile(0.95) << " / max " << times.back() << " ms\n"
+              << "Throughput:   " << vertices / (wallMs * 1000.0) << " Mvertices/s\n";
+
+    FLUSH_LOG_TO_FILE;
+    return EXIT_SUCCESS;
+}
\ No newline at end of file